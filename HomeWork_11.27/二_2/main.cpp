@@ -1,12 +1,1890 @@
 #include <iostream>
+#include <vector>
+#include <string>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <random>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+#endif
 using namespace std;
 
-class Matrix {
+// 运行 main --bench 执行性能测试
+
+//==============================================================================
+// 并行执行：矩阵运算共用的线程池
+//==============================================================================
+
+// 固定大小的线程池：run(f) 让调用线程（编号 0）与各工作线程同时执行 f(编号, 线程总数)
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex callMtx;  // 串行化来自不同外部线程的 run 调用
+    mutex mtx;
+    condition_variable start, finished;
+    function<void(int, int)> task;
+    unsigned long long generation = 0;
+    int running = 0;  // 尚未完成当前任务的工作线程数
+    bool stopping = false;
+
+    static bool& insidePool() {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void workerLoop(int id) {
+        insidePool() = true;
+        unsigned long long seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(mtx);
+                start.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            task(id, size());
+            {
+                lock_guard<mutex> lock(mtx);
+                if (--running == 0) finished.notify_one();
+            }
+        }
+    }
+
+    static unique_ptr<ThreadPool>& globalSlot() {
+        static unique_ptr<ThreadPool> pool;
+        return pool;
+    }
+
+public:
+    explicit ThreadPool(int threads) {
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)workers.size() + 1; }
+
+    // 在池内线程中再次调用时直接串行执行，避免嵌套死锁
+    template<typename F>
+    void run(F&& f) {
+        if (workers.empty() || insidePool()) {
+            f(0, 1);
+            return;
+        }
+        lock_guard<mutex> callLock(callMtx);
+        {
+            lock_guard<mutex> lock(mtx);
+            task = [&f](int id, int count) { f(id, count); };
+            running = (int)workers.size();
+            generation++;
+        }
+        start.notify_all();
+        insidePool() = true;
+        f(0, size());
+        insidePool() = false;
+        unique_lock<mutex> lock(mtx);
+        finished.wait(lock, [this]() { return running == 0; });
+    }
+
+    // 全局线程池，默认线程数为 CPU 核数
+    static ThreadPool& global() {
+        unique_ptr<ThreadPool>& pool = globalSlot();
+        if (!pool) pool.reset(new ThreadPool(max(1, (int)thread::hardware_concurrency())));
+        return *pool;
+    }
+
+    static void setGlobalThreads(int threads) {
+        globalSlot().reset(new ThreadPool(max(1, threads)));
+    }
+};
+
+// 并行参数
+struct ParallelConfig {
+    static size_t minElements;  // 元素数（或乘法的运算量）低于该值时串行执行
+    static bool firstTouch;     // 新分配的大矩阵由各线程并行初始化，页面落在首次写入它的线程所在的 NUMA 节点
+};
+
+size_t ParallelConfig::minElements = 1 << 15;
+bool ParallelConfig::firstTouch = true;
+
+void setMatrixThreads(int threads) {
+    ThreadPool::setGlobalThreads(threads);
+}
+
+// 把 [0, n) 按线程静态均分：同一编号的线程总是处理同一段，
+// 初始化与后续运算的划分一致，first-touch 分配的页面就在计算它的线程附近
+template<typename F>
+void parallelFor(size_t n, F&& f) {
+    ThreadPool& pool = ThreadPool::global();
+    if (pool.size() == 1 || n < ParallelConfig::minElements) {
+        f((size_t)0, n);
+        return;
+    }
+    pool.run([&](int id, int count) {
+        size_t lo = n * id / count;
+        size_t hi = n * (id + 1) / count;
+        if (lo < hi) f(lo, hi);
+    });
+}
+
+// 把 blocks 个任务块按轮转方式分给各线程，work 为总运算量，用于判断是否值得并行
+template<typename F>
+void parallelBlocks(int blocks, double work, F&& f) {
+    ThreadPool& pool = ThreadPool::global();
+    if (pool.size() == 1 || blocks <= 1 || work < ParallelConfig::minElements) {
+        for (int b = 0; b < blocks; b++) f(b);
+        return;
+    }
+    pool.run([&](int id, int count) {
+        for (int b = id; b < blocks; b += count) f(b);
+    });
+}
+
+//==============================================================================
+// 内存池：64 字节对齐、按大小分级缓存，大矩阵反复构造临时对象时不再每次向系统申请
+//==============================================================================
+
+struct PoolStats {
+    size_t requests = 0;      // allocate 调用次数
+    size_t systemAllocs = 0;  // 实际向系统申请的次数（缓存未命中）
+    size_t systemFrees = 0;   // 归还给系统的次数
+    size_t cachedBytes = 0;   // 当前缓存在空闲链表中的字节数
+};
+
+class AlignedPool {
+public:
+    static const size_t ALIGNMENT = 64;
+    static const size_t HUGE_PAGE = 2 << 20;
+
+private:
+    static const int CLASS_COUNT = 4 * 58 + 1;
+
+    mutex mtx;
+    vector<void*> freeLists[CLASS_COUNT];
+    PoolStats counters;
+    size_t maxCachedBytes = (size_t)1 << 30;
+    bool hugePages = false;
+
+    // 大小分级：64 字节以内为第 0 级；更大的块在每个 2 的幂区间内再分 4 级，浪费不超过 25%
+    static int sizeClass(size_t bytes, size_t& rounded) {
+        if (bytes <= 64) {
+            rounded = 64;
+            return 0;
+        }
+        int e = 6;
+        while (((size_t)1 << (e + 1)) < bytes) e++;  // 2^e < bytes <= 2^(e+1)
+        size_t step = (size_t)1 << (e - 2);
+        rounded = (bytes + step - 1) & ~(step - 1);
+        int k = (int)((rounded - ((size_t)1 << e)) / step);  // 1 ~ 4
+        return 1 + (e - 6) * 4 + (k - 1);
+    }
+
+    void* systemAlloc(size_t bytes) {
+        bool huge = hugePages && bytes >= HUGE_PAGE;
+        size_t align = huge ? HUGE_PAGE : ALIGNMENT;
+        void* p = nullptr;
+#ifdef _WIN32
+        p = _aligned_malloc(bytes, align);
+#else
+        if (posix_memalign(&p, align, bytes) != 0) p = nullptr;
+#ifdef MADV_HUGEPAGE
+        if (p && huge) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+#endif
+        if (!p) throw bad_alloc();
+        counters.systemAllocs++;
+        return p;
+    }
+
+    void systemFree(void* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+        counters.systemFrees++;
+    }
+
+    AlignedPool() = default;
+
+public:
+    AlignedPool(const AlignedPool&) = delete;
+    AlignedPool& operator=(const AlignedPool&) = delete;
+
+    // 有意不析构：线程池工作线程的 thread_local 缓冲区可能在静态对象析构之后才释放
+    static AlignedPool& instance() {
+        static AlignedPool* pool = new AlignedPool();
+        return *pool;
+    }
+
+    void* allocate(size_t bytes) {
+        size_t rounded;
+        int cls = sizeClass(max<size_t>(bytes, 1), rounded);
+        lock_guard<mutex> lock(mtx);
+        counters.requests++;
+        vector<void*>& list = freeLists[cls];
+        if (!list.empty()) {
+            void* p = list.back();
+            list.pop_back();
+            counters.cachedBytes -= rounded;
+            return p;
+        }
+        return systemAlloc(rounded);
+    }
+
+    // bytes 必须与 allocate 时相同
+    void deallocate(void* p, size_t bytes) {
+        if (!p) return;
+        size_t rounded;
+        int cls = sizeClass(max<size_t>(bytes, 1), rounded);
+        lock_guard<mutex> lock(mtx);
+        if (counters.cachedBytes + rounded > maxCachedBytes) {
+            systemFree(p);
+            return;
+        }
+        freeLists[cls].push_back(p);
+        counters.cachedBytes += rounded;
+    }
+
+    // 把缓存的空闲块全部归还给系统
+    void release() {
+        lock_guard<mutex> lock(mtx);
+        for (auto& list : freeLists) {
+            for (void* p : list) systemFree(p);
+            list.clear();
+        }
+        counters.cachedBytes = 0;
+    }
+
+    PoolStats stats() {
+        lock_guard<mutex> lock(mtx);
+        return counters;
+    }
+
+    // 2MB 及以上的块按大页对齐并请求透明大页（仅 Linux），减少大矩阵遍历时的 TLB 缺失
+    void setHugePages(bool enabled) {
+        lock_guard<mutex> lock(mtx);
+        hugePages = enabled;
+    }
+
+    void setMaxCachedBytes(size_t bytes) {
+        lock_guard<mutex> lock(mtx);
+        maxCachedBytes = bytes;
+    }
+};
+
+// 标准分配器接口，供 vector 与动态矩阵使用
+template<typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(AlignedPool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        AlignedPool::instance().deallocate(p, n * sizeof(T));
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+//==============================================================================
+// 表达式模板：矩阵运算先构建惰性表达式，赋值时在一个循环中一次算完，不产生临时矩阵
+//==============================================================================
+
+const int Dynamic = -1;  // 维度在运行期确定
+
+// Alloc 只对动态矩阵有效，决定数据缓冲区的分配方式
+template<typename T = int, int R = 2, int C = 3, typename Alloc = AlignedAllocator<T>>
+class Matrix;
+
+// 表达式基类（CRTP）：矩阵与矩阵表达式都派生自它
+// 派生类需提供 Scalar、RowsAtCompileTime、ColsAtCompileTime、rows()、cols()、coeff(k)
+template<typename E>
+struct MatrixExpr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+// 操作数的保存方式：矩阵按引用保存，子表达式（临时对象）按值保存
+template<typename E>
+struct ExprRef {
+    using type = const E;
+};
+
+template<typename T, int R, int C, typename Alloc>
+struct ExprRef<Matrix<T, R, C, Alloc>> {
+    using type = const Matrix<T, R, C, Alloc>&;
+};
+
+// 编译期维度检查：任一方为 Dynamic 时推迟到运行期
+template<int A, int B>
+struct SameDim {
+    static constexpr bool value = A == Dynamic || B == Dynamic || A == B;
+};
+
+template<typename L, typename R>
+void checkSameSize(const L& l, const R& r) {
+    static_assert(SameDim<L::RowsAtCompileTime, R::RowsAtCompileTime>::value, "矩阵行数不一致");
+    static_assert(SameDim<L::ColsAtCompileTime, R::ColsAtCompileTime>::value, "矩阵列数不一致");
+    if (l.rows() != r.rows() || l.cols() != r.cols()) {
+        throw invalid_argument("矩阵维度不一致");
+    }
+}
+
+struct AddOp {
+    template<typename A, typename B>
+    static auto apply(A a, B b) { return a + b; }
+};
+
+struct SubOp {
+    template<typename A, typename B>
+    static auto apply(A a, B b) { return a - b; }
+};
+
+template<typename S>
+struct ScaleOp {
+    S s;
+    template<typename A>
+    auto operator()(A a) const { return a * s; }
+};
+
+struct NegateOp {
+    template<typename A>
+    auto operator()(A a) const { return -a; }
+};
+
+// 逐元素二元表达式
+template<typename Op, typename L, typename R>
+class BinaryExpr : public MatrixExpr<BinaryExpr<Op, L, R>> {
+private:
+    typename ExprRef<L>::type lhs;
+    typename ExprRef<R>::type rhs;
+
+public:
+    using Scalar = decltype(Op::apply(declval<typename L::Scalar>(), declval<typename R::Scalar>()));
+    static constexpr int RowsAtCompileTime = L::RowsAtCompileTime != Dynamic ? L::RowsAtCompileTime : R::RowsAtCompileTime;
+    static constexpr int ColsAtCompileTime = L::ColsAtCompileTime != Dynamic ? L::ColsAtCompileTime : R::ColsAtCompileTime;
+
+    BinaryExpr(const L& l, const R& r) : lhs(l), rhs(r) { checkSameSize(l, r); }
+
+    int rows() const { return lhs.rows(); }
+    int cols() const { return lhs.cols(); }
+    Scalar coeff(size_t k) const { return Op::apply(lhs.coeff(k), rhs.coeff(k)); }
+    Scalar operator()(int i, int j) const { return coeff((size_t)i * cols() + j); }
+};
+
+// 逐元素一元表达式（取负、数乘）
+template<typename F, typename E>
+class UnaryExpr : public MatrixExpr<UnaryExpr<F, E>> {
+private:
+    typename ExprRef<E>::type expr;
+    F f;
+
+public:
+    using Scalar = decltype(declval<F>()(declval<typename E::Scalar>()));
+    static constexpr int RowsAtCompileTime = E::RowsAtCompileTime;
+    static constexpr int ColsAtCompileTime = E::ColsAtCompileTime;
+
+    UnaryExpr(const E& e, F f) : expr(e), f(f) {}
+
+    int rows() const { return expr.rows(); }
+    int cols() const { return expr.cols(); }
+    Scalar coeff(size_t k) const { return f(expr.coeff(k)); }
+    Scalar operator()(int i, int j) const { return coeff((size_t)i * cols() + j); }
+};
+
+// 重载+运算符
+template<typename L, typename R>
+BinaryExpr<AddOp, L, R> operator+(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+    return BinaryExpr<AddOp, L, R>(l.self(), r.self());
+}
+
+// 重载-运算符
+template<typename L, typename R>
+BinaryExpr<SubOp, L, R> operator-(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+    return BinaryExpr<SubOp, L, R>(l.self(), r.self());
+}
+
+template<typename E>
+UnaryExpr<NegateOp, E> operator-(const MatrixExpr<E>& e) {
+    return UnaryExpr<NegateOp, E>(e.self(), NegateOp());
+}
+
+// 数乘
+template<typename E, typename S, typename = enable_if_t<is_arithmetic<S>::value>>
+UnaryExpr<ScaleOp<S>, E> operator*(const MatrixExpr<E>& e, S s) {
+    return UnaryExpr<ScaleOp<S>, E>(e.self(), ScaleOp<S>{ s });
+}
+
+template<typename E, typename S, typename = enable_if_t<is_arithmetic<S>::value>>
+UnaryExpr<ScaleOp<S>, E> operator*(S s, const MatrixExpr<E>& e) {
+    return UnaryExpr<ScaleOp<S>, E>(e.self(), ScaleOp<S>{ s });
+}
+
+//==============================================================================
+// 定长矩阵 Matrix<T, R, C>：数据按行优先存放在对象内部
+//==============================================================================
+template<typename T, int R, int C, typename Alloc>
+class Matrix : public MatrixExpr<Matrix<T, R, C, Alloc>> {
+    static_assert(R > 0 && C > 0, "定长矩阵的行列数必须为正");
+
+private:
+    T data_[R * C];
+
+    // 单循环求值：表达式逐元素计算后直接写入
+    template<typename E>
+    void assign(const E& e) {
+        checkSameSize(*this, e);
+        for (size_t k = 0; k < (size_t)R * C; k++) {
+            data_[k] = (T)e.coeff(k);
+        }
+    }
+
+public:
+    using Scalar = T;
+    static constexpr int RowsAtCompileTime = R;
+    static constexpr int ColsAtCompileTime = C;
+
+    Matrix() : data_{} {}
+
+    Matrix(initializer_list<initializer_list<T>> rowsInit) : data_{} {
+        if ((int)rowsInit.size() != R) throw invalid_argument("初始化列表行数不一致");
+        int i = 0;
+        for (const auto& row : rowsInit) {
+            if ((int)row.size() != C) throw invalid_argument("初始化列表列数不一致");
+            int j = 0;
+            for (const T& v : row) data_[i * C + j++] = v;
+            i++;
+        }
+    }
+
+    template<typename E>
+    Matrix(const MatrixExpr<E>& e) { assign(e.self()); }
+
+    template<typename E>
+    Matrix& operator=(const MatrixExpr<E>& e) {
+        assign(e.self());
+        return *this;
+    }
+
+    template<typename E>
+    Matrix& operator+=(const MatrixExpr<E>& e) { return *this = *this + e; }
+
+    template<typename E>
+    Matrix& operator-=(const MatrixExpr<E>& e) { return *this = *this - e; }
+
+    int rows() const { return R; }
+    int cols() const { return C; }
+    size_t size() const { return (size_t)R * C; }
+
+    T& operator()(int i, int j) { return data_[i * C + j]; }
+    const T& operator()(int i, int j) const { return data_[i * C + j]; }
+    T coeff(size_t k) const { return data_[k]; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+};
+
+//==============================================================================
+// 动态矩阵 Matrix<T, Dynamic, Dynamic, Alloc>（别名 MatrixX<T>）
+//==============================================================================
+template<typename T, typename Alloc>
+class Matrix<T, Dynamic, Dynamic, Alloc> : public MatrixExpr<Matrix<T, Dynamic, Dynamic, Alloc>> {
+    static_assert(is_trivial<T>::value, "动态矩阵的元素类型必须是平凡类型");
+
+private:
+    int r, c;
+    T* data_;
+    Alloc alloc;
+
+    void release() {
+        if (data_) alloc.deallocate(data_, size());
+        data_ = nullptr;
+        r = c = 0;
+    }
+
+    // 只分配不初始化：页面在第一次写入时才真正分配
+    void allocate(int rows, int cols) {
+        if (rows < 0 || cols < 0) throw invalid_argument("矩阵维度不能为负");
+        release();
+        data_ = alloc.allocate((size_t)rows * cols);
+        r = rows;
+        c = cols;
+    }
+
+    void fill(T value) {
+        T* out = data_;
+        if (ParallelConfig::firstTouch) {
+            parallelFor(size(), [out, value](size_t lo, size_t hi) { std::fill(out + lo, out + hi, value); });
+        } else {
+            std::fill(out, out + size(), value);
+        }
+    }
+
+    // 单循环求值，大矩阵按行优先的连续区间分给各线程
+    template<typename E>
+    void assign(const E& e) {
+        if (!data_ || r != e.rows() || c != e.cols()) {
+            allocate(e.rows(), e.cols());
+        }
+        T* out = data_;
+        parallelFor(size(), [out, &e](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; k++) {
+                out[k] = (T)e.coeff(k);
+            }
+        });
+    }
+
+public:
+    using Scalar = T;
+    static constexpr int RowsAtCompileTime = Dynamic;
+    static constexpr int ColsAtCompileTime = Dynamic;
+
+    Matrix() : r(0), c(0), data_(nullptr) {}
+    Matrix(int rows, int cols, T value = T()) : r(0), c(0), data_(nullptr) {
+        allocate(rows, cols);
+        fill(value);
+    }
+
+    ~Matrix() { release(); }
+
+    Matrix(const Matrix& other) : r(0), c(0), data_(nullptr) { assign(other); }
+    Matrix(Matrix&& other) noexcept : r(other.r), c(other.c), data_(other.data_), alloc(move(other.alloc)) {
+        other.data_ = nullptr;
+        other.r = other.c = 0;
+    }
+
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) assign(other);
+        return *this;
+    }
+
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            release();
+            r = other.r;
+            c = other.c;
+            data_ = other.data_;
+            other.data_ = nullptr;
+            other.r = other.c = 0;
+        }
+        return *this;
+    }
+
+    template<typename E>
+    Matrix(const MatrixExpr<E>& e) : r(0), c(0), data_(nullptr) { assign(e.self()); }
+
+    template<typename E>
+    Matrix& operator=(const MatrixExpr<E>& e) {
+        assign(e.self());
+        return *this;
+    }
+
+    template<typename E>
+    Matrix& operator+=(const MatrixExpr<E>& e) { return *this = *this + e; }
+
+    template<typename E>
+    Matrix& operator-=(const MatrixExpr<E>& e) { return *this = *this - e; }
+
+    int rows() const { return r; }
+    int cols() const { return c; }
+    size_t size() const { return (size_t)r * c; }
+
+    T& operator()(int i, int j) { return data_[(size_t)i * c + j]; }
+    const T& operator()(int i, int j) const { return data_[(size_t)i * c + j]; }
+    T coeff(size_t k) const { return data_[k]; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+};
+
+// 默认使用 64 字节对齐的内存池；Matrix<T, Dynamic, Dynamic, allocator<T>> 则直接使用 new/delete
+template<typename T>
+using MatrixX = Matrix<T, Dynamic, Dynamic>;
+
+//==============================================================================
+// 矩阵乘法 GEMM：三级分块 + 面板打包 + 寄存器分块微内核
+// 微内核有 AVX2/FMA 版本（运行期检测 CPU 后启用）和通用标量版本
+//==============================================================================
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEMM_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// 通用微内核：C[MR x NR] += a(MR x kc) * b(kc x NR)
+// a 为打包后的 A 条带（每个 p 连续存放 MR 个元素），b 为打包后的 B 条带（每个 p 连续存放 NR 个元素）
+template<typename T>
+struct ScalarKernel {
+    static const int MR = 4;
+    static const int NR = 4;
+
+    static void run(int kc, const T* a, const T* b, T* c, int ldc) {
+        T acc[MR][NR] = {};
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < MR; i++) {
+                T ai = a[i];
+                for (int j = 0; j < NR; j++) {
+                    acc[i][j] += ai * b[j];
+                }
+            }
+            a += MR;
+            b += NR;
+        }
+        for (int i = 0; i < MR; i++) {
+            for (int j = 0; j < NR; j++) {
+                c[i * ldc + j] += acc[i][j];
+            }
+        }
+    }
+};
+
+#ifdef GEMM_X86_DISPATCH
+// double 微内核：6x8，12 个 ymm 累加器
+struct Avx2KernelD {
+    static const int MR = 6;
+    static const int NR = 8;
+
+    __attribute__((target("avx2,fma")))
+    static void run(int kc, const double* a, const double* b, double* c, int ldc) {
+        __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+        __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+        __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+        for (int p = 0; p < kc; p++) {
+            __m256d b0 = _mm256_loadu_pd(b);
+            __m256d b1 = _mm256_loadu_pd(b + 4);
+            __m256d ai;
+            ai = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+            ai = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+            ai = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+            ai = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+            ai = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+            ai = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+            a += MR;
+            b += NR;
+        }
+        __m256d acc[MR][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+        for (int i = 0; i < MR; i++) {
+            double* row = c + i * ldc;
+            _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), acc[i][0]));
+            _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), acc[i][1]));
+        }
+    }
+};
+
+// float 微内核：6x16，12 个 ymm 累加器
+struct Avx2KernelF {
+    static const int MR = 6;
+    static const int NR = 16;
+
+    __attribute__((target("avx2,fma")))
+    static void run(int kc, const float* a, const float* b, float* c, int ldc) {
+        __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+        __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+        __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+        __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+        __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+        __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+        for (int p = 0; p < kc; p++) {
+            __m256 b0 = _mm256_loadu_ps(b);
+            __m256 b1 = _mm256_loadu_ps(b + 8);
+            __m256 ai;
+            ai = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+            ai = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+            ai = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+            ai = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+            ai = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+            ai = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+            a += MR;
+            b += NR;
+        }
+        __m256 acc[MR][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+        for (int i = 0; i < MR; i++) {
+            float* row = c + i * ldc;
+            _mm256_storeu_ps(row, _mm256_add_ps(_mm256_loadu_ps(row), acc[i][0]));
+            _mm256_storeu_ps(row + 8, _mm256_add_ps(_mm256_loadu_ps(row + 8), acc[i][1]));
+        }
+    }
+};
+
+inline bool cpuHasAvx2Fma() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+#endif
+
+// 分块参数：KC x NR 的 B 条带驻留 L1，MC x KC 的 A 块驻留 L2，KC x NC 的 B 面板驻留 L3
+const int GEMM_KC = 256;
+const int GEMM_MC_BLOCKS = 16;  // MC = 16 * MR
+const int GEMM_NC = 2048;
+
+// 打包 A 的 mc x kc 子块：每 MR 行一个条带，乘以 alpha，不足 MR 行补 0
+template<typename T, int MR>
+void packA(int mc, int kc, const T* A, int lda, T alpha, T* dst) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int mr = min(MR, mc - ir);
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < mr; i++) {
+                dst[i] = alpha * A[(size_t)(ir + i) * lda + p];
+            }
+            for (int i = mr; i < MR; i++) {
+                dst[i] = T();
+            }
+            dst += MR;
+        }
+    }
+}
+
+// 打包 B 的 kc x nc 子块：每 NR 列一个条带，不足 NR 列补 0
+template<typename T, int NR>
+void packB(int kc, int nc, const T* B, int ldb, T* dst) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = min(NR, nc - jr);
+        for (int p = 0; p < kc; p++) {
+            const T* src = B + (size_t)p * ldb + jr;
+            for (int j = 0; j < nr; j++) {
+                dst[j] = src[j];
+            }
+            for (int j = nr; j < NR; j++) {
+                dst[j] = T();
+            }
+            dst += NR;
+        }
+    }
+}
+
+// 对打包好的一个 MC x KC 的 A 块与 KC x NC 的 B 面板执行宏内核
+template<typename T, typename Kernel>
+void gemmMacroKernel(int mc, int nc, int kc, const T* pa, const T* pb, T* C, int ldc) {
+    const int MR = Kernel::MR;
+    const int NR = Kernel::NR;
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = min(NR, nc - jr);
+        for (int ir = 0; ir < mc; ir += MR) {
+            int mr = min(MR, mc - ir);
+            const T* a = pa + (size_t)ir * kc;
+            const T* b = pb + (size_t)jr * kc;
+            T* c = C + (size_t)ir * ldc + jr;
+            if (mr == MR && nr == NR) {
+                Kernel::run(kc, a, b, c, ldc);
+            } else {
+                // 边缘块：先算到临时块，再把有效部分加回 C
+                T tile[MR * NR] = {};
+                Kernel::run(kc, a, b, tile, NR);
+                for (int i = 0; i < mr; i++) {
+                    for (int j = 0; j < nr; j++) {
+                        c[(size_t)i * ldc + j] += tile[i * NR + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T, typename Kernel>
+void gemmBlocked(int M, int N, int K, T alpha, const T* A, int lda, const T* B, int ldb, T* C, int ldc) {
+    const int MR = Kernel::MR;
+    const int NR = Kernel::NR;
+    const int MC = GEMM_MC_BLOCKS * MR;
+    static thread_local vector<T, AlignedAllocator<T>> bufB;
+    bufB.resize((size_t)GEMM_NC * GEMM_KC + NR * GEMM_KC);
+    T* pb = bufB.data();
+    double work = (double)M * N * K / 64;
+
+    for (int jc = 0; jc < N; jc += GEMM_NC) {
+        int nc = min(GEMM_NC, N - jc);
+        for (int pc = 0; pc < K; pc += GEMM_KC) {
+            int kc = min(GEMM_KC, K - pc);
+            const T* bsrc = B + (size_t)pc * ldb + jc;
+
+            // B 面板按 NR 列条带分给各线程打包
+            int slivers = (nc + NR - 1) / NR;
+            parallelBlocks(slivers, work, [&](int s) {
+                int j0 = s * NR;
+                packB<T, NR>(kc, min(NR, nc - j0), bsrc + j0, ldb, pb + (size_t)j0 * kc);
+            });
+
+            // 每个线程各自打包 A 块并计算 C 中互不重叠的 MC 行
+            int blocks = (M + MC - 1) / MC;
+            parallelBlocks(blocks, work, [&](int blk) {
+                static thread_local vector<T, AlignedAllocator<T>> bufA;
+                bufA.resize((size_t)MC * GEMM_KC);
+                int ic = blk * MC;
+                int mc = min(MC, M - ic);
+                packA<T, MR>(mc, kc, A + (size_t)ic * lda + pc, lda, alpha, bufA.data());
+                gemmMacroKernel<T, Kernel>(mc, nc, kc, bufA.data(), pb, C + (size_t)ic * ldc + jc, ldc);
+            });
+        }
+    }
+}
+
+// 行优先 GEMM：C = alpha * A(M x K) * B(K x N) + beta * C
+template<typename T>
+void gemm(int M, int N, int K, T alpha, const T* A, int lda, const T* B, int ldb, T beta, T* C, int ldc) {
+    if (M == 0 || N == 0) return;
+    if (beta != T(1)) {
+        parallelFor((size_t)M * N, [&](size_t lo, size_t hi) {
+            for (size_t i = lo / N; i * N < hi; i++) {
+                T* row = C + i * ldc;
+                size_t j0 = max(lo, i * N) - i * N;
+                size_t j1 = min(hi, (i + 1) * N) - i * N;
+                for (size_t j = j0; j < j1; j++) {
+                    row[j] = beta == T() ? T() : beta * row[j];
+                }
+            }
+        });
+    }
+    if (K == 0) return;  // A * B 为零矩阵，C 只做 beta 缩放
+
+#ifdef GEMM_X86_DISPATCH
+    if constexpr (is_same<T, double>::value) {
+        if (cpuHasAvx2Fma()) {
+            gemmBlocked<double, Avx2KernelD>(M, N, K, alpha, A, lda, B, ldb, C, ldc);
+            return;
+        }
+    } else if constexpr (is_same<T, float>::value) {
+        if (cpuHasAvx2Fma()) {
+            gemmBlocked<float, Avx2KernelF>(M, N, K, alpha, A, lda, B, ldb, C, ldc);
+            return;
+        }
+    }
+#endif
+    gemmBlocked<T, ScalarKernel<T>>(M, N, K, alpha, A, lda, B, ldb, C, ldc);
+}
+
+template<typename E>
+struct IsMatrix : false_type {};
+
+template<typename T, int R, int C, typename Alloc>
+struct IsMatrix<Matrix<T, R, C, Alloc>> : true_type {};
+
+// 把表达式求值为连续存放的矩阵；本身就是该类型的矩阵（任意分配器）时直接返回引用
+template<typename S, typename E>
+decltype(auto) evalAs(const MatrixExpr<E>& e) {
+    if constexpr (IsMatrix<E>::value && is_same<typename E::Scalar, S>::value) {
+        return e.self();
+    } else {
+        return Matrix<S, E::RowsAtCompileTime, E::ColsAtCompileTime>(e);
+    }
+}
+
+// 乘积的类型：行列都在编译期已知时为定长矩阵，否则为动态矩阵
+template<typename S, int R, int C>
+struct ProductType {
+    using type = conditional_t<R != Dynamic && C != Dynamic, Matrix<S, R, C>, MatrixX<S>>;
+};
+
+// 重载*运算符：矩阵乘法（立即求值）
+// 规模较小时直接三重循环，否则调用 gemm
+template<typename L, typename R>
+auto operator*(const MatrixExpr<L>& l, const MatrixExpr<R>& r) {
+    static_assert(SameDim<L::ColsAtCompileTime, R::RowsAtCompileTime>::value, "矩阵乘法内维不一致");
+    using S = common_type_t<typename L::Scalar, typename R::Scalar>;
+    using Result = typename ProductType<S, L::RowsAtCompileTime, R::ColsAtCompileTime>::type;
+
+    const auto& a = evalAs<S>(l);
+    const auto& b = evalAs<S>(r);
+    if (a.cols() != b.rows()) {
+        throw invalid_argument("矩阵乘法内维不一致");
+    }
+    int M = a.rows(), N = b.cols(), K = a.cols();
+
+    Result c;
+    if constexpr (Result::RowsAtCompileTime == Dynamic) {
+        c = MatrixX<S>(M, N);
+    }
+    if ((long long)M * N * K <= 32 * 32 * 32) {
+        for (int i = 0; i < M; i++) {
+            for (int p = 0; p < K; p++) {
+                S aip = a(i, p);
+                for (int j = 0; j < N; j++) {
+                    c(i, j) += aip * b(p, j);
+                }
+            }
+        }
+    } else {
+        gemm<S>(M, N, K, S(1), a.data(), K, b.data(), N, S(0), c.data(), N);
+    }
+    return c;
+}
+
+// 转置：按 32x32 的二维分块拷贝，分块按输出行分给各线程
+template<typename E>
+auto transpose(const MatrixExpr<E>& e) {
+    using S = typename E::Scalar;
+    using Result = typename ProductType<S, E::ColsAtCompileTime, E::RowsAtCompileTime>::type;
+    const int TILE = 32;
+
+    const auto& a = evalAs<S>(e);
+    int R = a.rows(), C = a.cols();
+    Result t;
+    if constexpr (Result::RowsAtCompileTime == Dynamic) {
+        t = MatrixX<S>(C, R);
+    }
+    const S* src = a.data();
+    S* dst = t.data();
+    int tileRows = (C + TILE - 1) / TILE;
+    parallelBlocks(tileRows, (double)R * C, [&](int tb) {
+        int i0 = tb * TILE, i1 = min(C, i0 + TILE);
+        for (int jb = 0; jb < R; jb += TILE) {
+            int j1 = min(R, jb + TILE);
+            for (int i = i0; i < i1; i++) {
+                for (int j = jb; j < j1; j++) {
+                    dst[(size_t)i * R + j] = src[(size_t)j * C + i];
+                }
+            }
+        }
+    });
+    return t;
+}
+
+//==============================================================================
+// 定长小矩阵 SmallMatrix<T, R, C>：全部运算为 constexpr，按下标序列在编译期展开
+//==============================================================================
+
+// 对齐到不超过 32 字节的、能整除矩阵大小的最大 2 的幂，便于编译器使用对齐的向量读写
+constexpr size_t smallMatrixAlign(size_t bytes) {
+    size_t a = 1;
+    while (a < 32 && bytes % (a * 2) == 0) a *= 2;
+    return a;
+}
+
+// 聚合类型，可平凡复制；数据按行优先存放，如 SmallMatrix<double, 2, 2>{ { 1, 2, 3, 4 } }
+template<typename T, int R, int C>
+struct alignas(smallMatrixAlign(sizeof(T) * R * C)) SmallMatrix {
+    static_assert(R > 0 && C > 0, "定长矩阵的行列数必须为正");
+    using Scalar = T;
+    static constexpr int RowsAtCompileTime = R;
+    static constexpr int ColsAtCompileTime = C;
+
+    T v[R * C];
+
+    constexpr T& operator()(int i, int j) { return v[i * C + j]; }
+    constexpr const T& operator()(int i, int j) const { return v[i * C + j]; }
+    constexpr int rows() const { return R; }
+    constexpr int cols() const { return C; }
+
+    static constexpr SmallMatrix identity() {
+        return generate([](int i, int j) { return i == j ? T(1) : T(0); });
+    }
+
+    // 按 f(i, j) 生成每个元素，下标序列展开后没有循环
+    template<typename F>
+    static constexpr SmallMatrix generate(F f) {
+        return generateImpl(f, make_index_sequence<R * C>());
+    }
+
+private:
+    template<typename F, size_t... I>
+    static constexpr SmallMatrix generateImpl(F f, index_sequence<I...>) {
+        return SmallMatrix{ { f((int)I / C, (int)I % C)... } };
+    }
+};
+
+template<typename T, int R, int C>
+constexpr SmallMatrix<T, R, C> operator+(const SmallMatrix<T, R, C>& a, const SmallMatrix<T, R, C>& b) {
+    return SmallMatrix<T, R, C>::generate([&](int i, int j) { return a(i, j) + b(i, j); });
+}
+
+template<typename T, int R, int C>
+constexpr SmallMatrix<T, R, C> operator-(const SmallMatrix<T, R, C>& a, const SmallMatrix<T, R, C>& b) {
+    return SmallMatrix<T, R, C>::generate([&](int i, int j) { return a(i, j) - b(i, j); });
+}
+
+template<typename T, int R, int C>
+constexpr SmallMatrix<T, R, C> operator*(const SmallMatrix<T, R, C>& a, T s) {
+    return SmallMatrix<T, R, C>::generate([&](int i, int j) { return a(i, j) * s; });
+}
+
+template<typename T, int R, int C>
+constexpr SmallMatrix<T, R, C> operator*(T s, const SmallMatrix<T, R, C>& a) {
+    return a * s;
+}
+
+template<typename T, int R, int C>
+constexpr bool operator==(const SmallMatrix<T, R, C>& a, const SmallMatrix<T, R, C>& b) {
+    for (int k = 0; k < R * C; k++) {
+        if (a.v[k] != b.v[k]) return false;
+    }
+    return true;
+}
+
+template<typename T, int R, int C>
+constexpr bool operator!=(const SmallMatrix<T, R, C>& a, const SmallMatrix<T, R, C>& b) {
+    return !(a == b);
+}
+
+// a 的第 i 行与 b 的第 j 列的内积，折叠表达式展开为 K 次乘加
+template<typename T, int R, int K, int C, size_t... P>
+constexpr T rowDotCol(const SmallMatrix<T, R, K>& a, const SmallMatrix<T, K, C>& b, int i, int j, index_sequence<P...>) {
+    return ((a(i, (int)P) * b((int)P, j)) + ...);
+}
+
+// 重载*运算符：矩阵乘法
+template<typename T, int R, int K, int C>
+constexpr SmallMatrix<T, R, C> operator*(const SmallMatrix<T, R, K>& a, const SmallMatrix<T, K, C>& b) {
+    return SmallMatrix<T, R, C>::generate([&](int i, int j) { return rowDotCol(a, b, i, j, make_index_sequence<K>()); });
+}
+
+template<typename T, int R, int C>
+constexpr SmallMatrix<T, C, R> transpose(const SmallMatrix<T, R, C>& a) {
+    return SmallMatrix<T, C, R>::generate([&](int i, int j) { return a(j, i); });
+}
+
+// 删去第 row 行、第 col 列得到的余子式矩阵
+template<typename T, int N>
+constexpr SmallMatrix<T, N - 1, N - 1> minorMatrix(const SmallMatrix<T, N, N>& a, int row, int col) {
+    return SmallMatrix<T, N - 1, N - 1>::generate([&](int i, int j) {
+        return a(i + (i >= row), j + (j >= col));
+    });
+}
+
+template<typename T, int N>
+constexpr T determinant(const SmallMatrix<T, N, N>& a);
+
+// 按第一行展开：sum (-1)^P * a(0, P) * det(M_0P)
+template<typename T, int N, size_t... P>
+constexpr T expandFirstRow(const SmallMatrix<T, N, N>& a, index_sequence<P...>) {
+    return (((P % 2 == 0 ? T(1) : T(-1)) * a(0, (int)P) * determinant(minorMatrix(a, 0, (int)P))) + ...);
+}
+
+// 行列式：1x1、2x2 直接计算，更大的按第一行递归展开（只用于 4x4 以内的小矩阵）
+template<typename T, int N>
+constexpr T determinant(const SmallMatrix<T, N, N>& a) {
+    if constexpr (N == 1) {
+        return a(0, 0);
+    } else if constexpr (N == 2) {
+        return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    } else {
+        return expandFirstRow(a, make_index_sequence<N>());
+    }
+}
+
+// 逆矩阵：伴随矩阵除以行列式；奇异矩阵抛出异常（在常量表达式中则成为编译错误）
+template<typename T, int N>
+constexpr SmallMatrix<T, N, N> inverse(const SmallMatrix<T, N, N>& a) {
+    T det = determinant(a);
+    if (det == T(0)) throw invalid_argument("矩阵不可逆");
+    if constexpr (N == 1) {
+        return SmallMatrix<T, 1, 1>{ { T(1) / det } };
+    } else {
+        return SmallMatrix<T, N, N>::generate([&](int i, int j) {
+            T cofactor = determinant(minorMatrix(a, j, i));
+            return ((i + j) % 2 == 0 ? cofactor : -cofactor) / det;
+        });
+    }
+}
+
+// 与表达式模板矩阵之间的转换
+template<typename T, int R, int C>
+Matrix<T, R, C> toMatrix(const SmallMatrix<T, R, C>& a) {
+    Matrix<T, R, C> m;
+    for (int k = 0; k < R * C; k++) m.data()[k] = a.v[k];
+    return m;
+}
+
+template<typename T, int R, int C>
+SmallMatrix<T, R, C> toSmallMatrix(const Matrix<T, R, C>& m) {
+    SmallMatrix<T, R, C> a{};
+    for (int k = 0; k < R * C; k++) a.v[k] = m.data()[k];
+    return a;
+}
+
+static_assert(is_trivially_copyable<SmallMatrix<double, 4, 4>>::value, "SmallMatrix 应可平凡复制");
+static_assert(sizeof(SmallMatrix<float, 2, 3>) == 6 * sizeof(float), "SmallMatrix 不应有填充");
+static_assert(determinant(SmallMatrix<int, 3, 3>{ { 1, 2, 3, 0, 1, 4, 5, 6, 0 } }) == 1, "行列式");
+static_assert(SmallMatrix<int, 2, 3>{ { 1, 2, 3, 4, 5, 6 } } * SmallMatrix<int, 3, 2>{ { 1, 0, 0, 1, 1, 1 } }
+              == SmallMatrix<int, 2, 2>{ { 4, 5, 10, 11 } }, "矩阵乘法");
+static_assert(inverse(SmallMatrix<double, 3, 3>{ { 1, 2, 3, 0, 1, 4, 5, 6, 0 } }) * SmallMatrix<double, 3, 3>{ { 1, 2, 3, 0, 1, 4, 5, 6, 0 } }
+              == SmallMatrix<double, 3, 3>::identity(), "逆矩阵");
+
+//==============================================================================
+// 流运算符
+//==============================================================================
+
+// 重载流提取运算符 >>
+template<typename T, int R, int C, typename Alloc>
+istream& operator>>(istream& is, Matrix<T, R, C, Alloc>& m) {
+    for (int i = 0; i < m.rows(); i++) {
+        for (int j = 0; j < m.cols(); j++) {
+            is >> m(i, j);
+        }
+    }
+    return is;
+}
+
+// 重载流插入运算符 <<（矩阵与表达式均可输出）
+template<typename E>
+ostream& operator<<(ostream& os, const MatrixExpr<E>& expr) {
+    const E& m = expr.self();
+    for (int i = 0; i < m.rows(); i++) {
+        for (int j = 0; j < m.cols(); j++) {
+            os << m(i, j) << "\t";
+        }
+        os << '\n';
+    }
+    return os;
+}
+
+//==============================================================================
+// 批量文件读写：文本格式（from_chars/to_chars，按行区间并行）与二进制格式
+//==============================================================================
+
+// 辅助函数：64 位文件定位；Windows 上 long 只有 32 位，fseek/ftell 处理不了 2 GB 以上的文件
+inline bool seekFile(FILE* fp, long long offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(fp, offset, origin) == 0;
+#else
+    return fseeko(fp, (off_t)offset, origin) == 0;
+#endif
+}
+
+// 辅助函数：文件总字节数，读写位置回到开头；失败返回 -1
+inline long long fileSize(FILE* fp) {
+    if (!seekFile(fp, 0, SEEK_END)) return -1;
+#ifdef _WIN32
+    long long size = _ftelli64(fp);
+#else
+    long long size = (long long)ftello(fp);
+#endif
+    if (!seekFile(fp, 0, SEEK_SET)) return -1;
+    return size;
+}
+
+// 辅助函数：一次读入整个文件
+inline vector<char> readWholeFile(const string& path) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) throw runtime_error("无法打开文件: " + path);
+    long long size = fileSize(fp);
+    if (size < 0 || (unsigned long long)size > SIZE_MAX) {
+        fclose(fp);
+        throw runtime_error("无法获取文件大小: " + path);
+    }
+    vector<char> buf((size_t)size);
+    size_t got = buf.empty() ? 0 : fread(buf.data(), 1, buf.size(), fp);
+    fclose(fp);
+    if (got != buf.size()) throw runtime_error("读取文件失败: " + path);
+    return buf;
+}
+
+inline bool isBlank(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+// 辅助函数：[p, end) 中下一行的结束位置（换行符处或 end）
+inline const char* lineEnd(const char* p, const char* end) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl : end;
+}
+
+inline bool isEmptyLine(const char* p, const char* e) {
+    while (p < e && isBlank(*p)) p++;
+    return p == e;
+}
+
+// 解析一行中的数值，返回个数；out 为空时只计数
+template<typename T>
+int parseLine(const char* p, const char* e, T* out, int maxCount) {
+    int n = 0;
+    while (true) {
+        while (p < e && isBlank(*p)) p++;
+        if (p == e) break;
+        if (n == maxCount) return maxCount + 1;
+        T value;
+        auto res = from_chars(p, e, value);
+        if (res.ec != errc()) return -1;
+        if (out) out[n] = value;
+        n++;
+        p = res.ptr;
+    }
+    return n;
+}
+
+// 读取文本矩阵：每个非空行一行，元素以空白分隔（与 operator<< 的输出格式相同）
+// 整个文件一次读入，按行边界切成若干段，各段并行计数、再并行解析到各自的行
+template<typename T>
+MatrixX<T> loadMatrixText(const string& path) {
+    vector<char> buf = readWholeFile(path);
+    const char* begin = buf.data();
+    const char* end = begin + buf.size();
+
+    // 列数取第一个非空行的元素个数
+    int cols = 0;
+    for (const char* p = begin; p < end;) {
+        const char* e = lineEnd(p, end);
+        if (!isEmptyLine(p, e)) {
+            cols = parseLine<T>(p, e, (T*)nullptr, INT32_MAX);
+            if (cols < 0) throw runtime_error("矩阵文件格式错误: " + path);
+            break;
+        }
+        p = e + 1;
+    }
+
+    int parts = buf.size() < (1 << 20) ? 1 : ThreadPool::global().size();
+    vector<const char*> cut(parts + 1);
+    cut[0] = begin;
+    cut[parts] = end;
+    for (int i = 1; i < parts; i++) {
+        const char* p = max(cut[i - 1], begin + buf.size() * i / parts);
+        cut[i] = p < end ? min(end, lineEnd(p, end) + 1) : end;
+    }
+
+    vector<size_t> rowsIn(parts + 1, 0);
+    parallelBlocks(parts, (double)buf.size(), [&](int part) {
+        size_t rows = 0;
+        for (const char* p = cut[part]; p < cut[part + 1];) {
+            const char* e = lineEnd(p, cut[part + 1]);
+            if (!isEmptyLine(p, e)) rows++;
+            p = e + 1;
+        }
+        rowsIn[part + 1] = rows;
+    });
+    for (int i = 0; i < parts; i++) rowsIn[i + 1] += rowsIn[i];
+    if (rowsIn[parts] > (size_t)INT32_MAX) throw runtime_error("矩阵行数过多: " + path);
+
+    MatrixX<T> m((int)rowsIn[parts], cols);
+    vector<string> errors(parts);
+    parallelBlocks(parts, (double)buf.size(), [&](int part) {
+        size_t row = rowsIn[part];
+        for (const char* p = cut[part]; p < cut[part + 1];) {
+            const char* e = lineEnd(p, cut[part + 1]);
+            if (!isEmptyLine(p, e)) {
+                if (parseLine<T>(p, e, m.data() + row * cols, cols) != cols) {
+                    errors[part] = "矩阵文件第 " + to_string(row + 1) + " 个非空行格式错误或列数不一致: " + path;
+                    return;
+                }
+                row++;
+            }
+            p = e + 1;
+        }
+    });
+    for (const auto& err : errors) {
+        if (!err.empty()) throw runtime_error(err);
+    }
+    return m;
+}
+
+// 写出文本矩阵：各线程用 to_chars 格式化一段行到各自的缓冲区，再按顺序整块写出，中途不刷新
+// 浮点数采用最短的可精确还原表示
+template<typename E>
+void saveMatrixText(const MatrixExpr<E>& e, const string& path) {
+    using S = typename E::Scalar;
+    const auto& m = evalAs<S>(e);
+    int rows = m.rows(), cols = m.cols();
+
+    int parts = (size_t)rows * cols < ParallelConfig::minElements ? 1 : ThreadPool::global().size();
+    vector<string> text(parts);
+    parallelBlocks(parts, (double)rows * cols, [&](int part) {
+        int r0 = (int)((long long)rows * part / parts);
+        int r1 = (int)((long long)rows * (part + 1) / parts);
+        string& out = text[part];
+        out.reserve((size_t)(r1 - r0) * cols * 12);
+        char tmp[64];
+        for (int i = r0; i < r1; i++) {
+            const S* row = m.data() + (size_t)i * cols;
+            for (int j = 0; j < cols; j++) {
+                out.append(tmp, to_chars(tmp, tmp + sizeof(tmp), row[j]).ptr);
+                out += '\t';
+            }
+            out += '\n';
+        }
+    });
+
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) throw runtime_error("无法创建文件: " + path);
+    bool ok = true;
+    for (const auto& t : text) {
+        ok = ok && fwrite(t.data(), 1, t.size(), fp) == t.size();
+    }
+    fclose(fp);
+    if (!ok) throw runtime_error("写入文件失败: " + path);
+}
+
+// 二进制格式：64 字节文件头 + 按行优先排列的原始数据（起始偏移按 64 字节对齐，小端序）
+struct MatrixFileHeader {
+    char magic[8];           // "MATRIX1"
+    uint32_t scalarCode;     // 元素类型编号，见 ScalarCode
+    uint32_t scalarSize;     // 元素字节数
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t payloadOffset;  // 数据起始偏移
+    char reserved[24];
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader 必须为 64 字节");
+
+const char MATRIX_MAGIC[8] = { 'M', 'A', 'T', 'R', 'I', 'X', '1', '\0' };
+
+template<typename T> struct ScalarCode;
+template<> struct ScalarCode<int> { static const uint32_t value = 1; };
+template<> struct ScalarCode<long long> { static const uint32_t value = 2; };
+template<> struct ScalarCode<float> { static const uint32_t value = 3; };
+template<> struct ScalarCode<double> { static const uint32_t value = 4; };
+
+template<typename T>
+MatrixFileHeader readMatrixHeader(FILE* fp, const string& path) {
+    MatrixFileHeader h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, MATRIX_MAGIC, 8) != 0) {
+        throw runtime_error("不是矩阵二进制文件: " + path);
+    }
+    if (h.scalarCode != ScalarCode<T>::value || h.scalarSize != sizeof(T)) {
+        throw runtime_error("矩阵文件的元素类型不匹配: " + path);
+    }
+    // 行列数要能放进 int，文件总长 payloadOffset + rows * cols * sizeof(T) 不能溢出 64 位；
+    // 映射后直接把 base + payloadOffset 当作 T* 使用，偏移必须是 alignof(T) 的倍数
+    if (h.rows > INT_MAX || h.cols > INT_MAX || h.payloadOffset < sizeof(MatrixFileHeader) ||
+        h.payloadOffset % alignof(T) != 0 ||
+        (h.cols != 0 && h.rows > UINT64_MAX / sizeof(T) / h.cols) ||
+        h.payloadOffset > UINT64_MAX - h.rows * h.cols * sizeof(T)) {
+        throw runtime_error("矩阵文件头损坏: " + path);
+    }
+    return h;
+}
+
+// 文件头描述的文件总字节数，须先经 readMatrixHeader 校验
+template<typename T>
+uint64_t matrixFileLength(const MatrixFileHeader& h) {
+    return h.payloadOffset + h.rows * h.cols * sizeof(T);
+}
+
+template<typename E>
+void saveMatrixBinary(const MatrixExpr<E>& e, const string& path) {
+    using S = typename E::Scalar;
+    const auto& m = evalAs<S>(e);
+    MatrixFileHeader h = {};
+    memcpy(h.magic, MATRIX_MAGIC, 8);
+    h.scalarCode = ScalarCode<S>::value;
+    h.scalarSize = sizeof(S);
+    h.rows = m.rows();
+    h.cols = m.cols();
+    h.payloadOffset = sizeof(MatrixFileHeader);
+
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) throw runtime_error("无法创建文件: " + path);
+    size_t n = (size_t)m.rows() * m.cols();
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(m.data(), sizeof(S), n, fp) == n;
+    fclose(fp);
+    if (!ok) throw runtime_error("写入文件失败: " + path);
+}
+
+// 读取二进制矩阵：数据一次读入矩阵自身的存储
+template<typename T>
+MatrixX<T> loadMatrixBinary(const string& path) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) throw runtime_error("无法打开文件: " + path);
+    MatrixFileHeader h;
+    try {
+        h = readMatrixHeader<T>(fp, path);
+    } catch (...) {
+        fclose(fp);
+        throw;
+    }
+    MatrixX<T> m((int)h.rows, (int)h.cols);
+    size_t got = seekFile(fp, (long long)h.payloadOffset, SEEK_SET) ? fread(m.data(), sizeof(T), m.size(), fp) : 0;
+    fclose(fp);
+    if (got != m.size()) throw runtime_error("矩阵文件数据不完整: " + path);
+    return m;
+}
+
+// 内存映射的只读矩阵：直接使用文件中的数据，不拷贝（零拷贝加载）
+// 可以像普通矩阵一样参与表达式运算
+template<typename T>
+class MappedMatrix : public MatrixExpr<MappedMatrix<T>> {
 private:
-    int data[2][3];
+    int r = 0, c = 0;
+    const T* ptr = nullptr;
+    void* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    void unmap() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (base) munmap(base, length);
+#endif
+        base = nullptr;
+    }
+
+public:
+    using Scalar = T;
+    static constexpr int RowsAtCompileTime = Dynamic;
+    static constexpr int ColsAtCompileTime = Dynamic;
+
+    explicit MappedMatrix(const string& path) {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp) throw runtime_error("无法打开文件: " + path);
+        MatrixFileHeader h;
+        try {
+            h = readMatrixHeader<T>(fp, path);
+        } catch (...) {
+            fclose(fp);
+            throw;
+        }
+        fclose(fp);
+        uint64_t required = matrixFileLength<T>(h);
+        if (required > SIZE_MAX) throw runtime_error("矩阵文件过大，无法映射: " + path);
+        length = (size_t)required;
+
+        // 映射前确认文件确实有这么长，否则访问末尾之外的页会触发 SIGBUS / 访问违例
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER fileBytes;
+        if (file != INVALID_HANDLE_VALUE && (!GetFileSizeEx(file, &fileBytes) || (uint64_t)fileBytes.QuadPart < required)) {
+            unmap();
+            throw runtime_error("矩阵文件数据不完整: " + path);
+        }
+        if (file != INVALID_HANDLE_VALUE) mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, length);
+        if (!base) {
+            unmap();
+            throw runtime_error("无法映射文件: " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("无法打开文件: " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < required) {
+            close(fd);
+            throw runtime_error("矩阵文件数据不完整: " + path);
+        }
+        void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw runtime_error("无法映射文件: " + path);
+        base = p;
+#endif
+        r = (int)h.rows;
+        c = (int)h.cols;
+        ptr = reinterpret_cast<const T*>(static_cast<const char*>(base) + h.payloadOffset);
+    }
+
+    ~MappedMatrix() { unmap(); }
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    int rows() const { return r; }
+    int cols() const { return c; }
+    size_t size() const { return (size_t)r * c; }
+    const T& operator()(int i, int j) const { return ptr[(size_t)i * c + j]; }
+    T coeff(size_t k) const { return ptr[k]; }
+    const T* data() const { return ptr; }
+};
+
+template<typename T>
+struct ExprRef<MappedMatrix<T>> {
+    using type = const MappedMatrix<T>&;
+};
+
+//==============================================================================
+// 稀疏矩阵：CSR（按行压缩）与 CSC（按列压缩）
+//==============================================================================
+
+template<typename T>
+struct Triplet {
+    int row, col;
+    T value;
+};
+
+template<typename T>
+class CscMatrix;
+
+// 辅助函数：检查维度并返回压缩指针数组（rowPtr/colPtr）的长度 n + 1
+// 在成员初始化列表中调用，负维度在分配之前就抛出 invalid_argument
+inline size_t sparsePtrLength(int rows, int cols, int n) {
+    if (rows < 0 || cols < 0) throw invalid_argument("矩阵维度不能为负");
+    return (size_t)n + 1;
+}
+
+// CSR 稀疏矩阵：rowPtr[i] ~ rowPtr[i+1] 为第 i 行非零元在 colIdx/values 中的区间，行内按列号升序
+template<typename T>
+class CsrMatrix {
+private:
+    int r, c;
+    vector<int> rowPtr;
+    vector<int> colIdx;
+    vector<T> values;
+
+    friend class CscMatrix<T>;
+
+    // 按非零元个数把行切成 parts 段，使每段的工作量大致相同（幂律分布的行也能均衡）
+    vector<int> nnzPartition(int parts) const {
+        vector<int> bounds(parts + 1, r);
+        bounds[0] = 0;
+        size_t nnz = values.size();
+        for (int p = 1; p < parts; p++) {
+            int target = (int)(nnz * p / parts);
+            int row = (int)(upper_bound(rowPtr.begin(), rowPtr.end(), target) - rowPtr.begin()) - 1;
+            bounds[p] = max(row, bounds[p - 1]);
+        }
+        return bounds;
+    }
+
+    // 按非零元均衡地把行区间分给各线程
+    template<typename F>
+    void forRowRanges(double work, F&& f) const {
+        ThreadPool& pool = ThreadPool::global();
+        if (pool.size() == 1 || work < ParallelConfig::minElements) {
+            f(0, r);
+            return;
+        }
+        vector<int> bounds = nnzPartition(pool.size());
+        pool.run([&](int id, int) {
+            if (bounds[id] < bounds[id + 1]) f(bounds[id], bounds[id + 1]);
+        });
+    }
+
+public:
+    using Scalar = T;
+
+    CsrMatrix(int rows = 0, int cols = 0) : r(rows), c(cols), rowPtr(sparsePtrLength(rows, cols, rows), 0) {}
+
+    // 由 COO 三元组构造：先按行计数排序，再在行内按列排序并合并重复位置（数值相加）
+    static CsrMatrix fromTriplets(int rows, int cols, const vector<Triplet<T>>& triplets) {
+        CsrMatrix m(rows, cols);
+        for (const auto& t : triplets) {
+            if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols) {
+                throw out_of_range("三元组下标越界: (" + to_string(t.row) + ", " + to_string(t.col) + ")");
+            }
+            m.rowPtr[t.row + 1]++;
+        }
+        for (int i = 0; i < rows; i++) m.rowPtr[i + 1] += m.rowPtr[i];
+
+        vector<int> cursor(m.rowPtr.begin(), m.rowPtr.end() - 1);
+        vector<pair<int, T>> entries(triplets.size());
+        for (const auto& t : triplets) {
+            entries[cursor[t.row]++] = { t.col, t.value };
+        }
+
+        m.colIdx.reserve(entries.size());
+        m.values.reserve(entries.size());
+        vector<int> newPtr(rows + 1, 0);
+        for (int i = 0; i < rows; i++) {
+            auto first = entries.begin() + m.rowPtr[i];
+            auto last = entries.begin() + m.rowPtr[i + 1];
+            sort(first, last, [](const pair<int, T>& a, const pair<int, T>& b) { return a.first < b.first; });
+            for (auto it = first; it != last; ++it) {
+                if ((int)m.colIdx.size() > newPtr[i] && m.colIdx.back() == it->first) {
+                    m.values.back() += it->second;
+                } else {
+                    m.colIdx.push_back(it->first);
+                    m.values.push_back(it->second);
+                }
+            }
+            newPtr[i + 1] = (int)m.colIdx.size();
+        }
+        m.rowPtr.swap(newPtr);
+        return m;
+    }
+
+    // 由稠密矩阵构造，绝对值不超过 tolerance 的元素视为 0
+    template<typename E>
+    static CsrMatrix fromDense(const MatrixExpr<E>& e, T tolerance = T()) {
+        const E& d = e.self();
+        CsrMatrix m(d.rows(), d.cols());
+        for (int i = 0; i < d.rows(); i++) {
+            for (int j = 0; j < d.cols(); j++) {
+                T v = (T)d(i, j);
+                if (v > tolerance || v < -tolerance) {
+                    m.colIdx.push_back(j);
+                    m.values.push_back(v);
+                }
+            }
+            m.rowPtr[i + 1] = (int)m.colIdx.size();
+        }
+        return m;
+    }
+
+    MatrixX<T> toDense() const {
+        MatrixX<T> d(r, c);
+        forRowRanges((double)r * c, [&](int r0, int r1) {
+            for (int i = r0; i < r1; i++) {
+                for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                    d(i, colIdx[k]) = values[k];
+                }
+            }
+        });
+        return d;
+    }
+
+    int rows() const { return r; }
+    int cols() const { return c; }
+    size_t nonZeros() const { return values.size(); }
+    size_t memoryBytes() const {
+        return rowPtr.size() * sizeof(int) + colIdx.size() * sizeof(int) + values.size() * sizeof(T);
+    }
+
+    const vector<int>& rowPointers() const { return rowPtr; }
+    const vector<int>& columnIndices() const { return colIdx; }
+    const vector<T>& nonZeroValues() const { return values; }
+
+    // 重载+运算符：逐行归并两个有序列表；先并行统计每行结果的非零元个数，再并行填充
+    CsrMatrix operator+(const CsrMatrix& other) const {
+        if (r != other.r || c != other.c) throw invalid_argument("矩阵维度不一致");
+        CsrMatrix result(r, c);
+        double work = (double)(nonZeros() + other.nonZeros());
+
+        forRowRanges(work, [&](int r0, int r1) {
+            for (int i = r0; i < r1; i++) {
+                int a = rowPtr[i], ae = rowPtr[i + 1];
+                int b = other.rowPtr[i], be = other.rowPtr[i + 1];
+                int count = 0;
+                while (a < ae && b < be) {
+                    if (colIdx[a] < other.colIdx[b]) a++;
+                    else if (colIdx[a] > other.colIdx[b]) b++;
+                    else { a++; b++; }
+                    count++;
+                }
+                result.rowPtr[i + 1] = count + (ae - a) + (be - b);
+            }
+        });
+        for (int i = 0; i < r; i++) result.rowPtr[i + 1] += result.rowPtr[i];
+        result.colIdx.resize(result.rowPtr[r]);
+        result.values.resize(result.rowPtr[r]);
+
+        forRowRanges(work, [&](int r0, int r1) {
+            for (int i = r0; i < r1; i++) {
+                int a = rowPtr[i], ae = rowPtr[i + 1];
+                int b = other.rowPtr[i], be = other.rowPtr[i + 1];
+                int out = result.rowPtr[i];
+                while (a < ae || b < be) {
+                    if (b == be || (a < ae && colIdx[a] < other.colIdx[b])) {
+                        result.colIdx[out] = colIdx[a];
+                        result.values[out++] = values[a++];
+                    } else if (a == ae || colIdx[a] > other.colIdx[b]) {
+                        result.colIdx[out] = other.colIdx[b];
+                        result.values[out++] = other.values[b++];
+                    } else {
+                        result.colIdx[out] = colIdx[a];
+                        result.values[out++] = values[a++] + other.values[b++];
+                    }
+                }
+            }
+        });
+        return result;
+    }
+
+    // SpMV：y = A * x，按非零元均衡的行区间并行
+    void multiply(const T* x, T* y) const {
+        forRowRanges(2.0 * nonZeros(), [&](int r0, int r1) {
+            for (int i = r0; i < r1; i++) {
+                T sum = T();
+                for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                    sum += values[k] * x[colIdx[k]];
+                }
+                y[i] = sum;
+            }
+        });
+    }
+
+    vector<T> operator*(const vector<T>& x) const {
+        if ((int)x.size() != c) throw invalid_argument("向量长度与矩阵列数不一致");
+        vector<T> y(r);
+        multiply(x.data(), y.data());
+        return y;
+    }
+
+    // SpMM：Y = A * X，X 为稠密矩阵；每个非零元把 X 的一整行累加到 Y 的对应行
+    template<typename E>
+    MatrixX<T> operator*(const MatrixExpr<E>& e) const {
+        const auto& x = evalAs<T>(e);
+        if (x.rows() != c) throw invalid_argument("矩阵乘法内维不一致");
+        int k = x.cols();
+        MatrixX<T> y(r, k);
+        forRowRanges(2.0 * nonZeros() * k, [&](int r0, int r1) {
+            for (int i = r0; i < r1; i++) {
+                T* out = y.data() + (size_t)i * k;
+                for (int p = rowPtr[i]; p < rowPtr[i + 1]; p++) {
+                    const T* in = x.data() + (size_t)colIdx[p] * k;
+                    T v = values[p];
+                    for (int j = 0; j < k; j++) {
+                        out[j] += v * in[j];
+                    }
+                }
+            }
+        });
+        return y;
+    }
+
+    CscMatrix<T> toCsc() const;
+};
+
+// CSC 稀疏矩阵：colPtr[j] ~ colPtr[j+1] 为第 j 列非零元的区间，列内按行号升序
+template<typename T>
+class CscMatrix {
+private:
+    int r, c;
+    vector<int> colPtr;
+    vector<int> rowIdx;
+    vector<T> values;
+
+public:
+    using Scalar = T;
+
+    CscMatrix(int rows = 0, int cols = 0) : r(rows), c(cols), colPtr(sparsePtrLength(rows, cols, cols), 0) {}
+
+    // 由 CSR 转换：按列计数后散列，遍历行的顺序保证列内行号有序
+    static CscMatrix fromCsr(const CsrMatrix<T>& a) {
+        CscMatrix m(a.r, a.c);
+        for (int col : a.colIdx) m.colPtr[col + 1]++;
+        for (int j = 0; j < m.c; j++) m.colPtr[j + 1] += m.colPtr[j];
+        m.rowIdx.resize(a.values.size());
+        m.values.resize(a.values.size());
+        vector<int> cursor(m.colPtr.begin(), m.colPtr.end() - 1);
+        for (int i = 0; i < a.r; i++) {
+            for (int k = a.rowPtr[i]; k < a.rowPtr[i + 1]; k++) {
+                int dst = cursor[a.colIdx[k]]++;
+                m.rowIdx[dst] = i;
+                m.values[dst] = a.values[k];
+            }
+        }
+        return m;
+    }
+
+    static CscMatrix fromTriplets(int rows, int cols, const vector<Triplet<T>>& triplets) {
+        return fromCsr(CsrMatrix<T>::fromTriplets(rows, cols, triplets));
+    }
+
+    template<typename E>
+    static CscMatrix fromDense(const MatrixExpr<E>& e, T tolerance = T()) {
+        return fromCsr(CsrMatrix<T>::fromDense(e, tolerance));
+    }
+
+    // 转置矩阵的 CSR 再按列重排一次，其列结构就是原矩阵的 CSR
+    CsrMatrix<T> toCsr() const {
+        CscMatrix<T> t = fromCsr(transposed());
+        CsrMatrix<T> m(r, c);
+        m.rowPtr = move(t.colPtr);
+        m.colIdx = move(t.rowIdx);
+        m.values = move(t.values);
+        return m;
+    }
+
+    MatrixX<T> toDense() const {
+        MatrixX<T> d(r, c);
+        for (int j = 0; j < c; j++) {
+            for (int k = colPtr[j]; k < colPtr[j + 1]; k++) {
+                d(rowIdx[k], j) = values[k];
+            }
+        }
+        return d;
+    }
+
+    int rows() const { return r; }
+    int cols() const { return c; }
+    size_t nonZeros() const { return values.size(); }
+
+    // 重载+运算符：与 CSR 相同，在转置意义下逐列归并
+    CscMatrix operator+(const CscMatrix& other) const {
+        if (r != other.r || c != other.c) throw invalid_argument("矩阵维度不一致");
+        CsrMatrix<T> sum = transposed() + other.transposed();
+        CscMatrix result(r, c);
+        result.colPtr = move(sum.rowPtr);
+        result.rowIdx = move(sum.colIdx);
+        result.values = move(sum.values);
+        return result;
+    }
+
+    // SpMV：y = A * x，按列把 x[j] 乘到该列的非零元上再散列累加
+    void multiply(const T* x, T* y) const {
+        fill(y, y + r, T());
+        for (int j = 0; j < c; j++) {
+            T xj = x[j];
+            for (int k = colPtr[j]; k < colPtr[j + 1]; k++) {
+                y[rowIdx[k]] += values[k] * xj;
+            }
+        }
+    }
+
+    vector<T> operator*(const vector<T>& x) const {
+        if ((int)x.size() != c) throw invalid_argument("向量长度与矩阵列数不一致");
+        vector<T> y(r);
+        multiply(x.data(), y.data());
+        return y;
+    }
+
+    // 列压缩存储按行解释即为转置矩阵的 CSR
+    CsrMatrix<T> transposed() const {
+        CsrMatrix<T> t(c, r);
+        t.rowPtr = colPtr;
+        t.colIdx = rowIdx;
+        t.values = values;
+        return t;
+    }
+};
 
+template<typename T>
+CscMatrix<T> CsrMatrix<T>::toCsc() const {
+    return CscMatrix<T>::fromCsr(*this);
+}
+
+//==============================================================================
+// 性能测试
+//==============================================================================
+
+// 原实现的逐次求值版本（每个 + 返回一个新矩阵），仅用于对比
+class EagerMatrix23 {
 public:
-    Matrix() {
+    int data[2][3];
+
+    EagerMatrix23() {
         for (int i = 0; i < 2; i++) {
             for (int j = 0; j < 3; j++) {
                 data[i][j] = 0;
@@ -14,9 +1892,8 @@ public:
         }
     }
 
-    // 重载+运算符
-    Matrix operator+(const Matrix& other) {
-        Matrix result;
+    EagerMatrix23 operator+(const EagerMatrix23& other) const {
+        EagerMatrix23 result;
         for (int i = 0; i < 2; i++) {
             for (int j = 0; j < 3; j++) {
                 result.data[i][j] = this->data[i][j] + other.data[i][j];
@@ -24,35 +1901,531 @@ public:
         }
         return result;
     }
+};
+
+// 动态大小的逐次求值版本
+class EagerMatrixX {
+public:
+    int r, c;
+    vector<double> data;
+
+    EagerMatrixX(int r, int c, double v = 0) : r(r), c(c), data((size_t)r * c, v) {}
+
+    EagerMatrixX operator+(const EagerMatrixX& other) const {
+        EagerMatrixX result(r, c);
+        for (size_t k = 0; k < data.size(); k++) result.data[k] = data[k] + other.data[k];
+        return result;
+    }
 
-    // 重载流运算符
-    friend istream& operator>>(istream& is, Matrix& m);
-    friend ostream& operator<<(ostream& os, const Matrix& m);
+    EagerMatrixX operator-(const EagerMatrixX& other) const {
+        EagerMatrixX result(r, c);
+        for (size_t k = 0; k < data.size(); k++) result.data[k] = data[k] - other.data[k];
+        return result;
+    }
+
+    EagerMatrixX operator*(double s) const {
+        EagerMatrixX result(r, c);
+        for (size_t k = 0; k < data.size(); k++) result.data[k] = data[k] * s;
+        return result;
+    }
 };
 
-// 重载流提取运算符 >>
-istream& operator>>(istream& is, Matrix& m) {
-    for (int i = 0; i < 2; i++) {
-        for (int j = 0; j < 3; j++) {
-            is >> m.data[i][j];
+double elapsedMs(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+    return chrono::duration<double, milli>(b - a).count();
+}
+
+// 链式逐元素表达式：表达式模板与逐次求值对比
+void benchExpressionTemplates() {
+    const int ITER = 10000000;
+    cout << "\n[表达式模板] 2x3 int, d = a + b + c + e, " << ITER << " 次" << endl;
+    {
+        EagerMatrix23 a, b, c, e, d;
+        long long check = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int it = 0; it < ITER; it++) {
+            a.data[0][0] = it;
+            d = a + b + c + e;
+            check += d.data[0][0];
         }
+        auto t1 = chrono::steady_clock::now();
+
+        Matrix<int, 2, 3> a2, b2, c2, e2, d2;
+        long long check2 = 0;
+        auto t2 = chrono::steady_clock::now();
+        for (int it = 0; it < ITER; it++) {
+            a2(0, 0) = it;
+            d2 = a2 + b2 + c2 + e2;
+            check2 += d2(0, 0);
+        }
+        auto t3 = chrono::steady_clock::now();
+        cout << "逐次求值: " << elapsedMs(t0, t1) << " ms" << endl;
+        cout << "表达式模板: " << elapsedMs(t2, t3) << " ms" << endl;
+        cout << "结果一致: " << (check == check2 ? "是" : "否") << endl;
+    }
+
+    const int N = 2000;
+    cout << "\n[表达式模板] " << N << "x" << N << " double, d = a + b + c + e 与 d = a * 2 - b + c" << endl;
+    {
+        EagerMatrixX a(N, N, 1), b(N, N, 2), c(N, N, 3), e(N, N, 4), d(N, N);
+        MatrixX<double> a2(N, N, 1), b2(N, N, 2), c2(N, N, 3), e2(N, N, 4), d2(N, N);
+
+        auto t0 = chrono::steady_clock::now();
+        d = a + b + c + e;
+        auto t1 = chrono::steady_clock::now();
+        d2 = a2 + b2 + c2 + e2;
+        auto t2 = chrono::steady_clock::now();
+        d = a * 2 - b + c;
+        auto t3 = chrono::steady_clock::now();
+        d2 = a2 * 2.0 - b2 + c2;
+        auto t4 = chrono::steady_clock::now();
+
+        cout << "a+b+c+e   逐次求值: " << elapsedMs(t0, t1) << " ms, 表达式模板: " << elapsedMs(t1, t2) << " ms" << endl;
+        cout << "a*2-b+c   逐次求值: " << elapsedMs(t2, t3) << " ms, 表达式模板: " << elapsedMs(t3, t4) << " ms" << endl;
+        cout << "结果一致: " << (d.data[12345] == d2.data()[12345] ? "是" : "否") << endl;
     }
-    return is;
 }
 
-// 重载流插入运算符 <<
-ostream& operator<<(ostream& os, const Matrix& m) {
-    for (int i = 0; i < 2; i++) {
-        for (int j = 0; j < 3; j++) {
-            os << m.data[i][j] << "\t";
+// 朴素三重循环（i-j-k），作为 GEMM 的对比基准
+template<typename T>
+void naiveMultiply(int n, const T* A, const T* B, T* C) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            T sum = 0;
+            for (int k = 0; k < n; k++) {
+                sum += A[(size_t)i * n + k] * B[(size_t)k * n + j];
+            }
+            C[(size_t)i * n + j] = sum;
         }
-        os << endl;
     }
-    return os;
 }
 
-int main() {
-    Matrix a, b, c;
+// GEMM 吞吐量：64 ~ 4096 方阵，朴素版本只测到 1024
+template<typename T>
+void benchGemm(const char* name) {
+    cout << "\n[GEMM] " << name << "  (GFLOP/s)" << endl;
+    cout << "n\t朴素\tgemm\t最大误差" << endl;
+    for (int n = 64; n <= 4096; n *= 2) {
+        MatrixX<T> a(n, n), b(n, n), c(n, n), ref(n, n);
+        for (size_t k = 0; k < a.size(); k++) {
+            a.data()[k] = (T)((int)(k * 7 % 13) - 6) / 8;
+            b.data()[k] = (T)((int)(k * 5 % 11) - 5) / 8;
+        }
+        double flops = 2.0 * n * n * n;
+        int repeat = max(1, (int)(2e9 / flops));
+
+        double naiveGflops = 0;
+        if (n <= 1024) {
+            auto t0 = chrono::steady_clock::now();
+            naiveMultiply(n, a.data(), b.data(), ref.data());
+            auto t1 = chrono::steady_clock::now();
+            naiveGflops = flops / (elapsedMs(t0, t1) * 1e6);
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            gemm<T>(n, n, n, T(1), a.data(), n, b.data(), n, T(0), c.data(), n);
+        }
+        auto t1 = chrono::steady_clock::now();
+        double gemmGflops = flops * repeat / (elapsedMs(t0, t1) * 1e6);
+
+        double maxErr = 0;
+        if (n <= 1024) {
+            for (size_t k = 0; k < c.size(); k++) {
+                maxErr = max(maxErr, (double)abs(c.data()[k] - ref.data()[k]));
+            }
+        }
+        cout << n << "\t";
+        if (n <= 1024) cout << naiveGflops; else cout << "-";
+        cout << "\t" << gemmGflops << "\t";
+        if (n <= 1024) cout << maxErr; else cout << "-";
+        cout << endl;
+    }
+}
+
+// 强扩展性：固定规模，线程数从 1 增加到 CPU 核数
+void benchScaling() {
+    const int N = 4096;
+    const int G = 1024;
+    int maxThreads = max(1, (int)thread::hardware_concurrency());
+    cout << "\n[多线程] 加法/数乘/转置 " << N << "x" << N << " double, 乘法 " << G << "x" << G << " double (ms)" << endl;
+    cout << "线程数\t加法\t数乘\t转置\t乘法\t乘法加速比" << endl;
+
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    double base = 0;
+    for (int t : counts) {
+        setMatrixThreads(t);
+        MatrixX<double> a(N, N, 1.5), b(N, N, 2.5), d(N, N);
+        MatrixX<double> ga(G, G, 0.5), gb(G, G, 0.25);
+
+        auto t0 = chrono::steady_clock::now();
+        d = a + b;
+        auto t1 = chrono::steady_clock::now();
+        d = a * 2.5;
+        auto t2 = chrono::steady_clock::now();
+        MatrixX<double> tr = transpose(a);
+        auto t3 = chrono::steady_clock::now();
+        MatrixX<double> gc = ga * gb;
+        auto t4 = chrono::steady_clock::now();
+
+        double mul = elapsedMs(t3, t4);
+        if (t == 1) base = mul;
+        cout << t << "\t" << elapsedMs(t0, t1) << "\t" << elapsedMs(t1, t2) << "\t" << elapsedMs(t2, t3)
+             << "\t" << mul << "\t" << base / mul << endl;
+    }
+    setMatrixThreads(maxThreads);
+}
+
+// 文件读写吞吐量：流运算符、from_chars/to_chars 文本格式、二进制格式
+void benchMatrixIO() {
+    const int N = 2000;
+    cout << "\n[矩阵读写] " << N << "x" << N << " double (MB/s)" << endl;
+    MatrixX<double> a(N, N);
+    for (size_t k = 0; k < a.size(); k++) a.data()[k] = (double)(k % 100003) / 7.0;
+
+    auto fileMB = [](const string& path) {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp) throw runtime_error("无法打开文件: " + path);
+        double mb = fileSize(fp) / (1024.0 * 1024.0);
+        fclose(fp);
+        return mb;
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    {
+        ofstream ofs("bench_matrix_stream.txt");
+        ofs.precision(17);
+        ofs << a;
+    }
+    auto t1 = chrono::steady_clock::now();
+    MatrixX<double> b(N, N);
+    {
+        ifstream ifs("bench_matrix_stream.txt");
+        ifs >> b;
+    }
+    auto t2 = chrono::steady_clock::now();
+    double streamMB = fileMB("bench_matrix_stream.txt");
+
+    saveMatrixText(a, "bench_matrix_fast.txt");
+    auto t3 = chrono::steady_clock::now();
+    MatrixX<double> c = loadMatrixText<double>("bench_matrix_fast.txt");
+    auto t4 = chrono::steady_clock::now();
+    double textMB = fileMB("bench_matrix_fast.txt");
+
+    saveMatrixBinary(a, "bench_matrix.bin");
+    auto t5 = chrono::steady_clock::now();
+    MatrixX<double> d = loadMatrixBinary<double>("bench_matrix.bin");
+    auto t6 = chrono::steady_clock::now();
+    double sum = 0;
+    {
+        MappedMatrix<double> e("bench_matrix.bin");
+        for (size_t k = 0; k < e.size(); k += 512) sum += e.coeff(k);
+    }
+    auto t7 = chrono::steady_clock::now();
+    double binMB = fileMB("bench_matrix.bin");
+
+    bool ok = true;
+    for (size_t k = 0; k < a.size() && ok; k++) {
+        ok = a.data()[k] == c.data()[k] && a.data()[k] == d.data()[k] && a.data()[k] == b.data()[k];
+    }
+    cout << "流运算符      写: " << streamMB / (elapsedMs(t0, t1) / 1000) << "  读: " << streamMB / (elapsedMs(t1, t2) / 1000) << endl;
+    cout << "文本(批量)    写: " << textMB / (elapsedMs(t2, t3) / 1000) << "  读: " << textMB / (elapsedMs(t3, t4) / 1000) << endl;
+    cout << "二进制        写: " << binMB / (elapsedMs(t4, t5) / 1000) << "  读: " << binMB / (elapsedMs(t5, t6) / 1000) << endl;
+    cout << "二进制映射    打开并抽样读取: " << elapsedMs(t6, t7) << " ms" << endl;
+    cout << "结果一致: " << (ok && sum > 0 ? "是" : "否") << endl;
+    remove("bench_matrix_stream.txt");
+    remove("bench_matrix_fast.txt");
+    remove("bench_matrix.bin");
+}
+
+// 合成的稀疏模式：二维五点差分（带状）、每行固定个数的均匀随机列、行长度服从幂律
+vector<Triplet<double>> makeSparsePattern(const string& kind, int n, unsigned seed) {
+    vector<Triplet<double>> t;
+    mt19937 rng(seed);
+    uniform_int_distribution<int> col(0, n - 1);
+    if (kind == "带状") {
+        int g = (int)sqrt((double)n);
+        for (int i = 0; i < n; i++) {
+            t.push_back({ i, i, 4.0 });
+            if (i % g != 0) t.push_back({ i, i - 1, -1.0 });
+            if (i % g != g - 1 && i + 1 < n) t.push_back({ i, i + 1, -1.0 });
+            if (i >= g) t.push_back({ i, i - g, -1.0 });
+            if (i + g < n) t.push_back({ i, i + g, -1.0 });
+        }
+    } else if (kind == "均匀随机") {
+        for (int i = 0; i < n; i++) {
+            for (int k = 0; k < 8; k++) t.push_back({ i, col(rng), 1.0 / (k + 1) });
+        }
+    } else {
+        // 第 i 行约有 n^0.6 / (i+1)^0.8 个非零元，开头几行极长
+        double top = pow((double)n, 0.6);
+        for (int i = 0; i < n; i++) {
+            int len = max(1, (int)(top / pow(i + 1.0, 0.8) * 8));
+            for (int k = 0; k < len; k++) t.push_back({ i, col(rng), 0.5 });
+        }
+    }
+    return t;
+}
+
+// SpMV 吞吐量（按非零元均衡划分 vs 按行数均分）、CSC SpMV、稀疏加法与 SpMM，最后与稠密矩阵向量乘对比
+void benchSparse() {
+    const int N = 1 << 18;
+    const int ITER = 20;
+    cout << "\n[稀疏矩阵] " << N << " 行 double, SpMV 重复 " << ITER << " 次 (GFLOP/s)" << endl;
+    cout << "模式\t非零元\t构造ms\tCSR\t行均分\tCSC\t加法ms\tSpMM(k=8)" << endl;
+
+    vector<double> x(N), y(N), y2(N);
+    for (int i = 0; i < N; i++) x[i] = 1.0 + (i % 7) * 0.125;
+
+    for (const char* kind : { "带状", "均匀随机", "幂律" }) {
+        vector<Triplet<double>> trip = makeSparsePattern(kind, N, 42);
+        auto t0 = chrono::steady_clock::now();
+        CsrMatrix<double> a = CsrMatrix<double>::fromTriplets(N, N, trip);
+        auto t1 = chrono::steady_clock::now();
+        double flops = 2.0 * a.nonZeros() * ITER;
+
+        for (int k = 0; k < ITER; k++) a.multiply(x.data(), y.data());
+        auto t2 = chrono::steady_clock::now();
+
+        // 对比：按行数静态均分，幂律分布时少数线程承担大部分非零元
+        const vector<int>& rp = a.rowPointers();
+        const vector<int>& ci = a.columnIndices();
+        const vector<double>& v = a.nonZeroValues();
+        for (int k = 0; k < ITER; k++) {
+            parallelFor(N, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) {
+                    double sum = 0;
+                    for (int p = rp[i]; p < rp[i + 1]; p++) sum += v[p] * x[ci[p]];
+                    y2[i] = sum;
+                }
+            });
+        }
+        auto t3 = chrono::steady_clock::now();
+
+        CscMatrix<double> csc = a.toCsc();
+        auto t4 = chrono::steady_clock::now();
+        for (int k = 0; k < ITER; k++) csc.multiply(x.data(), y2.data());
+        auto t5 = chrono::steady_clock::now();
+
+        CsrMatrix<double> s = a + a;
+        auto t6 = chrono::steady_clock::now();
+
+        const int K = 8;
+        MatrixX<double> xs(N, K);
+        for (size_t k = 0; k < xs.size(); k++) xs.data()[k] = x[k % N];
+        auto t7 = chrono::steady_clock::now();
+        MatrixX<double> ys = a * xs;
+        auto t8 = chrono::steady_clock::now();
+
+        double maxErr = 0;
+        for (int i = 0; i < N; i++) maxErr = max(maxErr, abs(y[i] - y2[i]));
+        bool ok = maxErr < 1e-9 && s.nonZeros() == a.nonZeros();
+        cout << kind << "\t" << a.nonZeros() << "\t" << elapsedMs(t0, t1)
+             << "\t" << flops / (elapsedMs(t1, t2) * 1e6)
+             << "\t" << flops / (elapsedMs(t2, t3) * 1e6)
+             << "\t" << flops / (elapsedMs(t4, t5) * 1e6)
+             << "\t" << elapsedMs(t5, t6)
+             << "\t" << 2.0 * a.nonZeros() * K / (elapsedMs(t7, t8) * 1e6)
+             << (ok && ys(0, 0) != 0 ? "" : "\t(结果不一致)") << endl;
+    }
+
+    // 与稠密存储对比：1% 密度的 4096x4096 矩阵
+    const int D = 4096;
+    vector<Triplet<double>> trip;
+    mt19937 rng(7);
+    uniform_int_distribution<int> col(0, D - 1);
+    for (int i = 0; i < D; i++) {
+        for (int k = 0; k < D / 100; k++) trip.push_back({ i, col(rng), 0.25 });
+    }
+    CsrMatrix<double> sp = CsrMatrix<double>::fromTriplets(D, D, trip);
+    MatrixX<double> dense = sp.toDense();
+    MatrixX<double> xv(D, 1, 1.0);
+
+    auto t0 = chrono::steady_clock::now();
+    vector<double> ys;
+    for (int k = 0; k < ITER; k++) ys = sp * vector<double>(D, 1.0);
+    auto t1 = chrono::steady_clock::now();
+    MatrixX<double> yd;
+    for (int k = 0; k < ITER; k++) yd = dense * xv;
+    auto t2 = chrono::steady_clock::now();
+
+    bool ok = CsrMatrix<double>::fromDense(dense).nonZeros() == sp.nonZeros();
+    for (int i = 0; i < D && ok; i++) ok = abs(ys[i] - yd(i, 0)) < 1e-9;
+    cout << "1% 密度 " << D << "x" << D << ": 稀疏 " << sp.memoryBytes() / 1024 << " KB, "
+         << elapsedMs(t0, t1) / ITER << " ms; 稠密 " << dense.size() * sizeof(double) / 1024 << " KB, "
+         << elapsedMs(t1, t2) / ITER << " ms; 结果一致: " << (ok ? "是" : "否") << endl;
+}
+
+// 小矩阵：constexpr 展开版本与定长 Matrix 的循环版本对比
+void benchSmallMatrix() {
+    const int COUNT = 1 << 16;
+    const int ITER = 100;
+    cout << "\n[小矩阵] " << COUNT << " 个矩阵 x " << ITER << " 轮 (ns/次)" << endl;
+
+    vector<SmallMatrix<double, 4, 4>> s4(COUNT);
+    vector<Matrix<double, 4, 4>> m4(COUNT);
+    vector<SmallMatrix<double, 3, 3>> s3(COUNT);
+    for (int n = 0; n < COUNT; n++) {
+        s4[n] = SmallMatrix<double, 4, 4>::generate([n](int i, int j) { return (double)((n + i * 5 + j * 3) % 7) - 3 + (i == j ? 8 : 0); });
+        m4[n] = toMatrix(s4[n]);
+        s3[n] = SmallMatrix<double, 3, 3>::generate([n](int i, int j) { return (double)((n + i * 2 + j) % 5) + (i == j ? 6 : 0); });
+    }
+    double ops = (double)COUNT * ITER;
+
+    auto t0 = chrono::steady_clock::now();
+    SmallMatrix<double, 4, 4> sAcc = SmallMatrix<double, 4, 4>::identity();
+    for (int it = 0; it < ITER; it++) {
+        for (int n = 0; n < COUNT; n++) sAcc = (sAcc * s4[n]) * 0.125;
+    }
+    auto t1 = chrono::steady_clock::now();
+    Matrix<double, 4, 4> mAcc = toMatrix(SmallMatrix<double, 4, 4>::identity());
+    for (int it = 0; it < ITER; it++) {
+        for (int n = 0; n < COUNT; n++) mAcc = (mAcc * m4[n]) * 0.125;
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    SmallMatrix<double, 4, 4> sSum{};
+    for (int it = 0; it < ITER; it++) {
+        for (int n = 0; n < COUNT; n++) sSum = sSum + s4[n] - s4[COUNT - 1 - n];
+    }
+    auto t3 = chrono::steady_clock::now();
+    Matrix<double, 4, 4> mSum;
+    for (int it = 0; it < ITER; it++) {
+        for (int n = 0; n < COUNT; n++) mSum = mSum + m4[n] - m4[COUNT - 1 - n];
+    }
+    auto t4 = chrono::steady_clock::now();
+
+    double detSum = 0;
+    SmallMatrix<double, 3, 3> invSum{};
+    for (int it = 0; it < ITER; it++) {
+        for (int n = 0; n < COUNT; n++) {
+            detSum += determinant(s4[n]);
+            invSum = invSum + inverse(s3[n]);
+        }
+    }
+    auto t5 = chrono::steady_clock::now();
+
+    double maxErr = 0;
+    for (int k = 0; k < 16; k++) {
+        maxErr = max(maxErr, abs(sAcc.v[k] - mAcc.data()[k]));
+        maxErr = max(maxErr, abs(sSum.v[k] - mSum.data()[k]));
+    }
+    cout << "4x4 乘法  循环: " << elapsedMs(t1, t2) * 1e6 / ops << ", 展开: " << elapsedMs(t0, t1) * 1e6 / ops << endl;
+    cout << "4x4 加减  循环: " << elapsedMs(t3, t4) * 1e6 / ops << ", 展开: " << elapsedMs(t2, t3) * 1e6 / ops << endl;
+    cout << "4x4 行列式 + 3x3 求逆: " << elapsedMs(t4, t5) * 1e6 / ops << " (校验和 " << detSum + invSum.v[0] << ")" << endl;
+    cout << "结果一致: " << (maxErr < 1e-9 ? "是" : "否") << endl;
+}
+
+// 数据 TLB 缺失计数（Linux perf_event），其他平台或无权限时不可用
+class TlbMissCounter {
+private:
+    int fd = -1;
+
+public:
+    TlbMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~TlbMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    long long read() const {
+        long long value = 0;
+#ifdef __linux__
+        if (fd >= 0 && ::read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value)) value = 0;
+#endif
+        return value;
+    }
+};
+
+// 内存池：反复构造大临时矩阵时的系统分配次数与耗时，大页对遍历大矩阵时 TLB 缺失的影响
+void benchAllocator() {
+    const int N = 1024;
+    const int ITER = 200;
+    cout << "\n[内存池] " << N << "x" << N << " double 临时矩阵, " << ITER << " 次" << endl;
+    AlignedPool& pool = AlignedPool::instance();
+    TlbMissCounter tlb;
+
+    MatrixX<double> a(N, N, 1.5);
+    Matrix<double, Dynamic, Dynamic, allocator<double>> sa(N, N, 1.5);
+    double sum = 0;
+
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < ITER; i++) {
+        Matrix<double, Dynamic, Dynamic, allocator<double>> t = sa * 2.0 + sa;
+        sum += t(i % N, i % N);
+    }
+    auto t1 = chrono::steady_clock::now();
+    PoolStats before = pool.stats();
+    for (int i = 0; i < ITER; i++) {
+        MatrixX<double> t = a * 2.0 + a;
+        sum += t(i % N, i % N);
+    }
+    auto t2 = chrono::steady_clock::now();
+    PoolStats after = pool.stats();
+
+    cout << "new/delete: " << elapsedMs(t0, t1) << " ms, 系统分配 " << ITER << " 次" << endl;
+    cout << "内存池:     " << elapsedMs(t1, t2) << " ms, 请求 " << after.requests - before.requests
+         << " 次, 系统分配 " << after.systemAllocs - before.systemAllocs << " 次" << endl;
+
+    const int L = 4096;
+    cout << "大页: " << L << "x" << L << " double 加法与转置" << (tlb.available() ? "" : "（TLB 计数不可用）") << endl;
+    for (bool huge : { false, true }) {
+        pool.release();
+        pool.setHugePages(huge);
+        MatrixX<double> x(L, L, 1.0), y(L, L, 2.0), z(L, L);
+        long long m0 = tlb.read();
+        auto t3 = chrono::steady_clock::now();
+        z = x + y;
+        MatrixX<double> tr = transpose(x);
+        auto t4 = chrono::steady_clock::now();
+        long long m1 = tlb.read();
+        sum += z(1, 2) + tr(2, 1);
+        cout << (huge ? "  开启: " : "  关闭: ") << elapsedMs(t3, t4) << " ms";
+        if (tlb.available()) cout << ", dTLB 缺失 " << m1 - m0;
+        cout << endl;
+    }
+    pool.setHugePages(false);
+    pool.release();
+    cout << "校验和: " << sum << endl;
+}
+
+void runBenchmarks() {
+    cout << "========== 性能测试 ==========" << endl;
+    benchExpressionTemplates();
+    benchGemm<double>("double");
+    benchGemm<float>("float");
+    benchScaling();
+    benchMatrixIO();
+    benchSparse();
+    benchSmallMatrix();
+    benchAllocator();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        runBenchmarks();
+        return 0;
+    }
+
+    Matrix<int, 2, 3> a, b, c;
 
     cout << "a：" << endl;
     cin >> a;
@@ -73,4 +2446,3 @@ int main() {
 
     return 0;
 }
-
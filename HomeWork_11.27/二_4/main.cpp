@@ -1,5 +1,20 @@
 #include <iostream>
+#include <fstream>
 #include <cmath>
+#include <vector>
+#include <string>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
 using namespace std;
 
 class Shape {
@@ -51,7 +66,565 @@ void printArea(Shape* shape) {
     cout << "面积为: " << shape->getArea() << endl;
 }
 
-int main() {
+//==============================================================================
+// 批处理：从文件或标准输入读取大量图形记录，按类型分桶后批量计算面积
+// 每行一条记录：circle r / rectangle l w / triangle b h，输出按输入顺序每行一个面积
+// 运行 main --batch [输入文件] [输出文件] [--threads N]，文件名为 - 表示标准输入/输出
+// 运行 main --bench [记录数] 执行性能测试
+//==============================================================================
+
+const size_t BLOCK_BYTES = 4 << 20;  // 每次读取的块大小
+
+// 一个块中的记录按类型分桶，数据按结构数组存放；idx 为记录在块内的序号
+struct ShapeBatch {
+    vector<double> circleR;
+    vector<uint32_t> circleIdx;
+    vector<double> rectL, rectW;
+    vector<uint32_t> rectIdx;
+    vector<double> triB, triH;
+    vector<uint32_t> triIdx;
+    size_t count = 0;
+
+    void clear() {
+        circleR.clear();
+        circleIdx.clear();
+        rectL.clear();
+        rectW.clear();
+        rectIdx.clear();
+        triB.clear();
+        triH.clear();
+        triIdx.clear();
+        count = 0;
+    }
+};
+
+inline bool isBlank(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) p++;
+    return p;
+}
+
+// from_chars 不接受前导 '+'，而流读取（operator>>）接受；先跳过它，两条路径对同一输入的解析结果一致
+inline const char* parseNumber(const char* p, const char* end, double& value, const char* line, const char* lineEnd) {
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+' && !(p + 1 < end && p[1] == '-')) p++;
+    auto res = from_chars(p, end, value);
+    if (res.ec != errc()) {
+        throw runtime_error("无效的记录: " + string(line, lineEnd));
+    }
+    return res.ptr;
+}
+
+// 解析一个块 [p, end)，块内只含完整的行
+void parseBlock(const char* p, const char* end, ShapeBatch& batch) {
+    batch.clear();
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+        if (!lineEnd) lineEnd = end;
+        const char* q = skipBlanks(p, lineEnd);
+        if (q < lineEnd) {
+            const char* word = q;
+            while (q < lineEnd && !isBlank(*q)) q++;
+            size_t len = q - word;
+            uint32_t idx = (uint32_t)batch.count++;
+            double a, b;
+            if (len == 6 && memcmp(word, "circle", 6) == 0) {
+                q = parseNumber(q, lineEnd, a, p, lineEnd);
+                batch.circleR.push_back(a);
+                batch.circleIdx.push_back(idx);
+            } else if (len == 9 && memcmp(word, "rectangle", 9) == 0) {
+                q = parseNumber(q, lineEnd, a, p, lineEnd);
+                q = parseNumber(q, lineEnd, b, p, lineEnd);
+                batch.rectL.push_back(a);
+                batch.rectW.push_back(b);
+                batch.rectIdx.push_back(idx);
+            } else if (len == 8 && memcmp(word, "triangle", 8) == 0) {
+                q = parseNumber(q, lineEnd, a, p, lineEnd);
+                q = parseNumber(q, lineEnd, b, p, lineEnd);
+                batch.triB.push_back(a);
+                batch.triH.push_back(b);
+                batch.triIdx.push_back(idx);
+            } else {
+                throw runtime_error("未知的图形类型: " + string(p, lineEnd));
+            }
+            if (skipBlanks(q, lineEnd) != lineEnd) {
+                throw runtime_error("无效的记录: " + string(p, lineEnd));
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+//==============================================================================
+// 面积计算内核：每种图形一个批量函数，运算顺序与 getArea() 相同，结果逐位一致
+// x86 上运行期检测到 AVX2 时使用 256 位向量版本
+//==============================================================================
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AREA_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+void circleAreasScalar(const double* r, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = 3.14159 * r[i] * r[i];
+}
+
+void rectAreasScalar(const double* l, const double* w, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = l[i] * w[i];
+}
+
+void triangleAreasScalar(const double* b, const double* h, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = 0.5 * b[i] * h[i];
+}
+
+#ifdef AREA_X86_DISPATCH
+__attribute__((target("avx2")))
+void circleAreasAvx2(const double* r, double* out, size_t n) {
+    const __m256d pi = _mm256_set1_pd(3.14159);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(r + i);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_mul_pd(pi, v), v));
+    }
+    circleAreasScalar(r + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void rectAreasAvx2(const double* l, const double* w, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(l + i), _mm256_loadu_pd(w + i)));
+    }
+    rectAreasScalar(l + i, w + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void triangleAreasAvx2(const double* b, const double* h, double* out, size_t n) {
+    const __m256d half = _mm256_set1_pd(0.5);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_mul_pd(half, _mm256_loadu_pd(b + i));
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(v, _mm256_loadu_pd(h + i)));
+    }
+    triangleAreasScalar(b + i, h + i, out + i, n - i);
+}
+
+inline bool cpuHasAvx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+#endif
+
+// 按类型批量计算，再按记录序号写回 areas（长度为 batch.count）
+void computeAreas(const ShapeBatch& batch, vector<double>& areas, vector<double>& scratch) {
+    areas.resize(batch.count);
+    auto scatter = [&](const vector<uint32_t>& idx) {
+        for (size_t i = 0; i < idx.size(); i++) areas[idx[i]] = scratch[i];
+    };
+#ifdef AREA_X86_DISPATCH
+    bool avx2 = cpuHasAvx2();
+#endif
+
+    scratch.resize(batch.circleR.size());
+#ifdef AREA_X86_DISPATCH
+    if (avx2) circleAreasAvx2(batch.circleR.data(), scratch.data(), scratch.size());
+    else
+#endif
+    circleAreasScalar(batch.circleR.data(), scratch.data(), scratch.size());
+    scatter(batch.circleIdx);
+
+    scratch.resize(batch.rectL.size());
+#ifdef AREA_X86_DISPATCH
+    if (avx2) rectAreasAvx2(batch.rectL.data(), batch.rectW.data(), scratch.data(), scratch.size());
+    else
+#endif
+    rectAreasScalar(batch.rectL.data(), batch.rectW.data(), scratch.data(), scratch.size());
+    scatter(batch.rectIdx);
+
+    scratch.resize(batch.triB.size());
+#ifdef AREA_X86_DISPATCH
+    if (avx2) triangleAreasAvx2(batch.triB.data(), batch.triH.data(), scratch.data(), scratch.size());
+    else
+#endif
+    triangleAreasScalar(batch.triB.data(), batch.triH.data(), scratch.data(), scratch.size());
+    scatter(batch.triIdx);
+}
+
+// 面积格式化为文本，一行一个；6 位有效数字，与 cout 的默认格式相同
+void formatAreas(const vector<double>& areas, string& text) {
+    text.resize(areas.size() * 16);
+    char* out = &text[0];
+    for (double a : areas) {
+        out = to_chars(out, out + 15, a, chars_format::general, 6).ptr;
+        *out++ = '\n';
+    }
+    text.resize(out - text.data());
+}
+
+//==============================================================================
+// 输入输出：按块读取（块尾不完整的行留到下一块），带缓冲的写出
+//==============================================================================
+
+class BlockReader {
+private:
+    FILE* fp;
+    string carry;  // 上一块末尾不完整的一行
+
+public:
+    explicit BlockReader(FILE* fp) : fp(fp) {}
+
+    // 读取下一块到 block，保证只包含完整的行；到达文件末尾返回 false
+    bool next(string& block) {
+        block.swap(carry);
+        carry.clear();
+        size_t old = block.size();
+        block.resize(old + BLOCK_BYTES);
+        size_t got = fread(&block[old], 1, BLOCK_BYTES, fp);
+        block.resize(old + got);
+        if (got == BLOCK_BYTES) {
+            size_t cut = block.rfind('\n');
+            if (cut != string::npos) {
+                carry.assign(block, cut + 1, string::npos);
+                block.resize(cut + 1);
+            }
+        }
+        return !block.empty();
+    }
+};
+
+class BufferedWriter {
+private:
+    FILE* fp;
+    string buffer;
+
+public:
+    explicit BufferedWriter(FILE* fp) : fp(fp) { buffer.reserve(BLOCK_BYTES * 2); }
+    ~BufferedWriter() { flush(); }
+
+    void write(const string& text) {
+        buffer += text;
+        if (buffer.size() >= BLOCK_BYTES) flush();
+    }
+
+    void flush() {
+        if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), fp) != buffer.size()) {
+            throw runtime_error("写入输出失败");
+        }
+        buffer.clear();
+    }
+};
+
+//==============================================================================
+// 批处理入口：单线程依次执行，或多线程流水线（读取 -> 解析/计算/格式化 -> 按序写出）
+//==============================================================================
+
+// 有界阻塞队列，用于流水线各级之间传递块
+template<typename T>
+class BlockQueue {
+private:
+    mutex mtx;
+    condition_variable notEmpty, notFull;
+    deque<T> items;
+    size_t capacity;
+    bool closed = false;
+
+public:
+    explicit BlockQueue(size_t capacity) : capacity(capacity) {}
+
+    // 队列已关闭（出错中止）时返回 false
+    bool push(T item) {
+        unique_lock<mutex> lock(mtx);
+        notFull.wait(lock, [&]() { return items.size() < capacity || closed; });
+        if (closed) return false;
+        items.push_back(move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // 队列关闭且为空时返回 false
+    bool pop(T& item) {
+        unique_lock<mutex> lock(mtx);
+        notEmpty.wait(lock, [&]() { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> lock(mtx);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+};
+
+struct BatchJob {
+    size_t seq = 0;
+    string text;
+};
+
+// 处理 in 中的全部记录并写到 out，返回记录数；threads <= 1 时单线程执行
+size_t processShapes(FILE* in, FILE* out, int threads) {
+    BlockReader reader(in);
+    BufferedWriter writer(out);
+    size_t records = 0;
+
+    if (threads <= 1) {
+        string block, text;
+        ShapeBatch batch;
+        vector<double> areas, scratch;
+        while (reader.next(block)) {
+            parseBlock(block.data(), block.data() + block.size(), batch);
+            computeAreas(batch, areas, scratch);
+            formatAreas(areas, text);
+            writer.write(text);
+            records += batch.count;
+        }
+        writer.flush();
+        return records;
+    }
+
+    BlockQueue<BatchJob> inputs(threads * 2), outputs(threads * 2);
+    mutex errorMtx;
+    string error;
+    auto fail = [&](const string& what) {
+        lock_guard<mutex> lock(errorMtx);
+        if (error.empty()) error = what;
+        inputs.close();
+        outputs.close();
+    };
+
+    thread readerThread([&]() {
+        BatchJob job;
+        try {
+            while (reader.next(job.text)) {
+                size_t seq = job.seq;
+                if (!inputs.push(move(job))) break;
+                job = BatchJob();
+                job.seq = seq + 1;
+            }
+        } catch (const exception& e) {
+            fail(e.what());
+        }
+        inputs.close();
+    });
+
+    mutex countMtx;
+    int alive = threads;
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            ShapeBatch batch;
+            vector<double> areas, scratch;
+            BatchJob job;
+            try {
+                while (inputs.pop(job)) {
+                    parseBlock(job.text.data(), job.text.data() + job.text.size(), batch);
+                    computeAreas(batch, areas, scratch);
+                    formatAreas(areas, job.text);
+                    {
+                        lock_guard<mutex> lock(countMtx);
+                        records += batch.count;
+                    }
+                    if (!outputs.push(move(job))) break;
+                }
+            } catch (const exception& e) {
+                fail(e.what());
+            }
+            lock_guard<mutex> lock(countMtx);
+            if (--alive == 0) outputs.close();
+        });
+    }
+
+    // 写出级：块可能乱序完成，按编号暂存后依次写出
+    map<size_t, string> pending;
+    size_t nextSeq = 0;
+    BatchJob done;
+    try {
+        while (outputs.pop(done)) {
+            pending[done.seq] = move(done.text);
+            for (auto it = pending.find(nextSeq); it != pending.end(); it = pending.find(++nextSeq)) {
+                writer.write(it->second);
+                pending.erase(it);
+            }
+        }
+        writer.flush();
+    } catch (const exception& e) {
+        fail(e.what());
+    }
+
+    readerThread.join();
+    for (auto& w : workers) w.join();
+    if (!error.empty()) throw runtime_error(error);
+    return records;
+}
+
+//==============================================================================
+// 性能测试
+//==============================================================================
+
+double elapsedSeconds(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+    return chrono::duration<double>(b - a).count();
+}
+
+// 生成 records 条随机记录（三种图形各约三分之一）
+void writeShapeRecords(const string& path, size_t records) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) throw runtime_error("无法创建文件: " + path);
+    BufferedWriter writer(fp);
+    string line;
+    unsigned long long state = 88172645463325252ULL;
+    auto nextValue = [&]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (double)(state % 100000) / 100 + 0.01;
+    };
+    char num[32];
+    auto append = [&](double v) {
+        line += ' ';
+        line.append(num, to_chars(num, num + sizeof(num), v).ptr);
+    };
+    for (size_t i = 0; i < records; i++) {
+        line.clear();
+        switch (i % 3) {
+        case 0: line = "circle"; append(nextValue()); break;
+        case 1: line = "rectangle"; append(nextValue()); append(nextValue()); break;
+        default: line = "triangle"; append(nextValue()); append(nextValue()); break;
+        }
+        line += '\n';
+        writer.write(line);
+    }
+    writer.flush();
+    fclose(fp);
+}
+
+// 原来的方式：逐条创建对象、调用虚函数 getArea()、每个结果 endl
+size_t processShapesOneByOne(const string& inPath, const string& outPath, size_t limit) {
+    ifstream in(inPath);
+    ofstream out(outPath);
+    string type;
+    size_t n = 0;
+    while (n < limit && in >> type) {
+        Shape* shape;
+        double a, b;
+        if (type == "circle") {
+            in >> a;
+            shape = new Circle(a);
+        } else if (type == "rectangle") {
+            in >> a >> b;
+            shape = new Rectangle(a, b);
+        } else {
+            in >> a >> b;
+            shape = new Triangle(a, b);
+        }
+        out << shape->getArea() << endl;
+        delete shape;
+        n++;
+    }
+    return n;
+}
+
+// 比较两个文件的前 bytes 个字节（文件较短时比较到末尾）
+bool sameFileContents(const string& a, const string& b, size_t bytes = SIZE_MAX) {
+    ifstream fa(a, ios::binary), fb(b, ios::binary);
+    vector<char> ba(1 << 20), bb(1 << 20);
+    while (bytes > 0) {
+        size_t want = min(bytes, ba.size());
+        fa.read(ba.data(), want);
+        fb.read(bb.data(), want);
+        if (fa.gcount() != fb.gcount() || memcmp(ba.data(), bb.data(), (size_t)fa.gcount()) != 0) return false;
+        if ((size_t)fa.gcount() < want) return true;
+        bytes -= want;
+    }
+    return true;
+}
+
+void runBenchmarks(size_t records) {
+    const string input = "bench_shapes.txt";
+    const size_t ONE_BY_ONE = min<size_t>(records, 1000000);
+    int threads = max(2, (int)thread::hardware_concurrency());
+    cout << "========== 性能测试 ==========" << endl;
+    cout << "生成 " << records << " 条记录..." << endl;
+    writeShapeRecords(input, records);
+
+    auto t0 = chrono::steady_clock::now();
+    processShapesOneByOne(input, "bench_areas_ref.txt", ONE_BY_ONE);
+    auto t1 = chrono::steady_clock::now();
+
+    FILE* in = fopen(input.c_str(), "rb");
+    FILE* out = fopen("bench_areas_1.txt", "wb");
+    size_t n1 = processShapes(in, out, 1);
+    fclose(in);
+    fclose(out);
+    auto t2 = chrono::steady_clock::now();
+
+    in = fopen(input.c_str(), "rb");
+    out = fopen("bench_areas_n.txt", "wb");
+    size_t n2 = processShapes(in, out, threads);
+    fclose(in);
+    fclose(out);
+    auto t3 = chrono::steady_clock::now();
+
+    cout << "逐个对象 + endl (" << ONE_BY_ONE << " 条): " << ONE_BY_ONE / elapsedSeconds(t0, t1) << " 条/秒" << endl;
+    cout << "批处理单线程: " << n1 / elapsedSeconds(t1, t2) << " 条/秒" << endl;
+    cout << "批处理流水线 (" << threads << " 个计算线程): " << n2 / elapsedSeconds(t2, t3) << " 条/秒" << endl;
+
+    ifstream ref("bench_areas_ref.txt", ios::binary | ios::ate);
+    size_t refBytes = (size_t)ref.tellg();
+    bool ok = n1 == records && n2 == records
+        && sameFileContents("bench_areas_ref.txt", "bench_areas_1.txt", refBytes)
+        && sameFileContents("bench_areas_1.txt", "bench_areas_n.txt");
+    cout << "结果一致: " << (ok ? "是" : "否") << endl;
+    remove(input.c_str());
+    remove("bench_areas_ref.txt");
+    remove("bench_areas_1.txt");
+    remove("bench_areas_n.txt");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        runBenchmarks(argc > 2 ? stoull(argv[2]) : 100000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        string inPath = "-", outPath = "-";
+        int threads = 1;
+        int files = 0;
+        for (int i = 2; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                threads = stoi(argv[++i]);
+            } else if (files == 0) {
+                inPath = arg;
+                files++;
+            } else {
+                outPath = arg;
+            }
+        }
+        FILE* in = inPath == "-" ? stdin : fopen(inPath.c_str(), "rb");
+        FILE* out = outPath == "-" ? stdout : fopen(outPath.c_str(), "wb");
+        if (!in || !out) {
+            cerr << "无法打开文件" << endl;
+            return 1;
+        }
+        try {
+            size_t records = processShapes(in, out, threads);
+            cerr << "共处理 " << records << " 条记录" << endl;
+        } catch (const exception& e) {
+            cerr << "错误: " << e.what() << endl;
+            return 1;
+        }
+        if (in != stdin) fclose(in);
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
     Circle circle(5.0);           // 圆形，半径为5
     Rectangle rectangle(4.0, 6.0); // 矩形，长为4，宽为6
     Triangle triangle(3.0, 4.0);   // 三角形，底为3，高为4
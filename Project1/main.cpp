@@ -1,7 +1,8 @@
 /*
  * 实验一：类和对象 - 平面几何图形类实现
- * 功能：实现点、线段、圆、矩形、三角形类及其各种变换操作
- * 使用EGE图形库进行可视化
+ * 功能：实现点、线段、圆、矩形、三角形类及其各种变换操作；点集的凸包、最近点对与 k-d 树近邻查询
+ * 使用EGE图形库进行可视化；编译时定义 SHAPE_TRACE 可统计各图形虚函数的调用耗时并导出 Chrome trace
+ * 运行 main --bench 执行性能测试；main --animate [图形数] [帧数] [--headless] 运行连续动画并导出帧时间
  */
 
  #include <graphics.h>
@@ -9,6 +10,18 @@
  #include <vector>
  #include <string>
  #include <sstream>
+ #include <iostream>
+ #include <chrono>
+ #include <type_traits>
+ #include <algorithm>
+ #include <random>
+ #include <fstream>
+ #include <iomanip>
+ #include <cstdlib>
+ #include <thread>
+ #include <limits>
+ #include <stdexcept>
+ #include <cstdint>
  
  using namespace std;
  
@@ -16,13 +29,57 @@ const double MY_PI = 3.14159265358979323846;
 const int WINDOW_WIDTH = 1200;
 const int WINDOW_HEIGHT = 800;
 
-class Point;
+// 顶点：只有两个坐标的 POD 类型，可以直接 memcpy、放进连续数组
+template<typename T>
+struct Vec2 {
+    T x, y;
+
+    double distanceTo(const Vec2& o) const {
+        double dx = (double)x - o.x, dy = (double)y - o.y;
+        return sqrt(dx * dx + dy * dy);
+    }
+};
+
+static_assert(is_trivially_copyable<Vec2<float>>::value && is_standard_layout<Vec2<float>>::value, "Vec2 必须是 POD");
+static_assert(is_trivially_copyable<Vec2<double>>::value && is_standard_layout<Vec2<double>>::value, "Vec2 必须是 POD");
+static_assert(sizeof(Vec2<float>) == 2 * sizeof(float), "Vec2 不应有填充");
+
+// 复合图形内部顶点的精度：定义 SHAPE_FLOAT_VERTICES 时用 float，顶点内存减半，
+// 坐标在 ±16777216 内保持整数精确，足够覆盖屏幕坐标；运算仍按 double 进行后再存回
+#ifdef SHAPE_FLOAT_VERTICES
+typedef float VertexScalar;
+#else
+typedef double VertexScalar;
+#endif
+typedef Vec2<VertexScalar> Vertex;
+
+inline Vertex makeVertex(double x, double y) { return { (VertexScalar)x, (VertexScalar)y }; }
+
+//==============================================================================
+// 绘制命令队列：DrawCommand、RenderBackend（EgeBackend/CountingBackend）与 RenderQueue，与实验二共用
+//==============================================================================
+
+#include "../Shared/render_queue.h"
+
+//==============================================================================
+// 调用追踪：TRACE_TYPE / TRACE_CALL / TRACE_SPAN / TRACE_REPORT，与实验二共用；定义 SHAPE_TRACE 才启用
+//==============================================================================
+
+#include "../Shared/shape_trace.h"
+
+// 顶点标记：以顶点为中心的小实心圆
+void drawVertex(RenderQueue& queue, const Vertex& v, color_t color) {
+    queue.addFillEllipse((int)(v.x - 2), (int)(v.y - 2), 5, 5, color, 2);
+}
 
 class Shape {
 protected:
-    static void rotatePointAround(Point& p, const Point& center, double angle);
-    static void mirrorPointAround(Point& p, const Point& center, bool horizontal);
-    static void scalePointAround(Point& p, const Point& center, double factor);
+    static void rotatePointAround(Vertex& p, const Vertex& center, double angle);
+    static void mirrorPointAround(Vertex& p, const Vertex& center, bool horizontal);
+    static void scalePointAround(Vertex& p, const Vertex& center, double factor);
+#ifdef SHAPE_TRACE
+    virtual const char* traceName() const = 0;  // 由各图形类里的 TRACE_TYPE 生成
+#endif
 
 public:
     Shape() = default;
@@ -30,14 +87,18 @@ public:
 
     virtual double getArea() const = 0;
     virtual double getPerimeter() const = 0;
-    virtual void draw(color_t color) const = 0;
+    // 只把绘制命令记录到 queue，由 queue.flush() 统一提交
+    virtual void draw(RenderQueue& queue, color_t color) const = 0;
     virtual void rotate(double angle) = 0;
     virtual void mirror(bool horizontal) = 0;
     virtual void scale(double factor) = 0;
     virtual void move(double dx, double dy) = 0;
     virtual string getInfo() const = 0;
+    // 按顺序追加图形的顶点坐标，供批量变换使用
+    virtual void appendVertices(vector<double>& xs, vector<double>& ys) const = 0;
 };
 
+// 独立的点图形；复合图形内部的顶点用 Vertex 保存，不再是 Point
 class Point : public Shape {
  private:
      double x, y;
@@ -45,6 +106,8 @@ class Point : public Shape {
      static int instanceCount;
 
  public:
+     TRACE_TYPE(Point)
+
      Point(double x = 0, double y = 0, bool registerInstance = false)
          : x(x), y(y), counted(registerInstance) {
          if (counted) {
@@ -61,6 +124,8 @@ class Point : public Shape {
          return *this;
      }
 
+     Vertex position() const { return makeVertex(x, y); }
+
      ~Point() override {
          if (counted) {
              --instanceCount;
@@ -74,16 +139,16 @@ class Point : public Shape {
      void setX(double newX) { x = newX; }
      void setY(double newY) { y = newY; }
 
-     double getArea() const override { return 0; }
+     double getArea() const override { TRACE_CALL(GetArea); return 0; }
      double getPerimeter() const override { return 0; }
  
-     void draw(color_t color) const override {
-         setcolor(color);
-         setfillcolor(color);
-         fillellipse((int)(x - 2), (int)(y - 2), 5, 5);
+     void draw(RenderQueue& queue, color_t color) const override {
+         TRACE_CALL(Draw);
+         queue.addFillEllipse((int)(x - 2), (int)(y - 2), 5, 5, color, 2);
      }
  
      void rotate(double angle) override {
+         TRACE_CALL(Rotate);
          double rad = angle * MY_PI / 180.0;
          double newX = x * cos(rad) - y * sin(rad);
          double newY = x * sin(rad) + y * cos(rad);
@@ -92,6 +157,7 @@ class Point : public Shape {
      }
 
      void mirror(bool horizontal) override {
+         TRACE_CALL(Mirror);
          if (horizontal) {
              y = -y;
          } else {
@@ -100,131 +166,780 @@ class Point : public Shape {
      }
 
      void scale(double factor) override {
+         TRACE_CALL(Scale);
          x *= factor;
          y *= factor;
      }
 
      void move(double dx, double dy) override {
+         TRACE_CALL(Move);
          x += dx;
          y += dy;
      }
  
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "点" << " 位于 (" << x << ", " << y << ")";
         oss << " | 面积: 0";
         oss << " | 周长: 0";
         return oss.str();
     }
+
+    void appendVertices(vector<double>& xs, vector<double>& ys) const override {
+        xs.push_back(x);
+        ys.push_back(y);
+    }
  
     double distanceTo(const Point& p) const {
         return sqrt((x - p.x) * (x - p.x) + (y - p.y) * (y - p.y));
     }
 };
 
-void Shape::rotatePointAround(Point& p, const Point& center, double angle) {
-    double rad = angle * MY_PI / 180.0;
-    double x = p.getX() - center.getX();
-    double y = p.getY() - center.getY();
-    double newX = x * cos(rad) - y * sin(rad) + center.getX();
-    double newY = x * sin(rad) + y * cos(rad) + center.getY();
-    p.setX(newX);
-    p.setY(newY);
+// 二维仿射变换：2x3 矩阵 [a b tx; c d ty]，按行优先存放，与 Matrix<double, 2, 3> 的布局一致
+// 点 (x, y) 变换为 (a*x + b*y + tx, c*x + d*y + ty)
+struct Affine2D {
+    double a, b, tx;
+    double c, d, ty;
+
+    static Affine2D identity() { return { 1, 0, 0, 0, 1, 0 }; }
+
+    static Affine2D translation(double dx, double dy) { return { 1, 0, dx, 0, 1, dy }; }
+
+    // 绕 center 旋转 angle 度
+    template<typename T>
+    static Affine2D rotationAround(const Vec2<T>& center, double angle) {
+        double rad = angle * MY_PI / 180.0;
+        double cs = cos(rad), sn = sin(rad);
+        double cx = center.x, cy = center.y;
+        return { cs, -sn, cx - cs * cx + sn * cy,
+                 sn, cs, cy - sn * cx - cs * cy };
+    }
+
+    // 以 center 为中心缩放 factor 倍
+    template<typename T>
+    static Affine2D scalingAround(const Vec2<T>& center, double factor) {
+        double cx = center.x, cy = center.y;
+        return { factor, 0, cx * (1 - factor),
+                 0, factor, cy * (1 - factor) };
+    }
+
+    // 关于过 center 的水平线（horizontal）或竖直线镜像
+    template<typename T>
+    static Affine2D mirrorAround(const Vec2<T>& center, bool horizontal) {
+        if (horizontal) {
+            return { 1, 0, 0, 0, -1, 2.0 * center.y };
+        }
+        return { -1, 0, 2.0 * center.x, 0, 1, 0 };
+    }
+
+    double determinant() const { return a * d - b * c; }
+
+    // 先做 other 再做 *this
+    Affine2D operator*(const Affine2D& o) const {
+        return { a * o.a + b * o.c, a * o.b + b * o.d, a * o.tx + b * o.ty + tx,
+                 c * o.a + d * o.c, c * o.b + d * o.d, c * o.tx + d * o.ty + ty };
+    }
+
+    // 逆变换；奇异矩阵（行列式为 0）返回 false，result 不变
+    bool inverse(Affine2D& result) const {
+        double det = determinant();
+        if (det == 0) return false;
+        double inv = 1.0 / det;
+        double ia = d * inv, ib = -b * inv, ic = -c * inv, id = a * inv;
+        result = { ia, ib, -(ia * tx + ib * ty),
+                   ic, id, -(ic * tx + id * ty) };
+        return true;
+    }
+
+    void apply(Point& p) const {
+        double x = p.getX(), y = p.getY();
+        p.setX(a * x + b * y + tx);
+        p.setY(c * x + d * y + ty);
+    }
+
+    // 按 double 计算后存回顶点的精度
+    template<typename T>
+    void apply(Vec2<T>& p) const {
+        double x = p.x, y = p.y;
+        p.x = (T)(a * x + b * y + tx);
+        p.y = (T)(c * x + d * y + ty);
+    }
+};
+
+// 把同一个矩阵作用到一段连续顶点上；系数先转成 T，float 顶点按 float 运算，一次向量指令处理的顶点数翻倍
+template<typename T>
+void transformVertices(const Affine2D& m, Vec2<T>* v, size_t count) {
+    const T a = (T)m.a, b = (T)m.b, tx = (T)m.tx, c = (T)m.c, d = (T)m.d, ty = (T)m.ty;
+    for (size_t i = 0; i < count; i++) {
+        T x = v[i].x, y = v[i].y;
+        v[i].x = a * x + b * y + tx;
+        v[i].y = c * x + d * y + ty;
+    }
+}
+
+// 批量运算：每个实例一个 2x3 矩阵，顶点按 x、y 分开连续存放，
+// 第 i 个实例的顶点为 [offsets[i], offsets[i + 1])
+
+// out[i] = first[i] 之后再做 then[i]；out 可以与任一输入相同
+void composeAffine(const Affine2D* then, const Affine2D* first, Affine2D* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = then[i] * first[i];
+    }
+}
+
+// 批量求逆，返回奇异矩阵的个数；奇异矩阵的结果置为单位矩阵
+size_t invertAffine(const Affine2D* in, Affine2D* out, size_t count) {
+    size_t singular = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!in[i].inverse(out[i])) {
+            out[i] = Affine2D::identity();
+            singular++;
+        }
+    }
+    return singular;
+}
+
+// 把每个实例的矩阵作用到它的顶点区间上：(xs, ys) -> (outX, outY)，输入输出不重叠
+// 每个实例只有 1 ~ 4 个顶点，内层循环太短，编译器不会有效向量化；
+// 省下的是逐个虚函数调用和逐顶点的三角函数，顶点多时耗时主要取决于内存带宽
+void applyAffine(const Affine2D* transforms, const size_t* offsets, size_t count,
+                 const double* __restrict xs, const double* __restrict ys,
+                 double* __restrict outX, double* __restrict outY) {
+    for (size_t i = 0; i < count; i++) {
+        const Affine2D m = transforms[i];
+        for (size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+            double x = xs[k], y = ys[k];
+            outX[k] = m.a * x + m.b * y + m.tx;
+            outY[k] = m.c * x + m.d * y + m.ty;
+        }
+    }
+}
+
+//==============================================================================
+// 点集几何算法：鲁棒方向判定、并行凸包、最近点对
+//==============================================================================
+
+// 无误差变换：a + b、a * b 拆成舍入结果 x 与舍入误差 y，x + y 精确等于真实值
+inline void twoSum(double a, double b, double& x, double& y) {
+    double s = a + b;
+    double bv = s - a;
+    y = (a - (s - bv)) + (b - bv);
+    x = s;
+}
+
+inline void twoProduct(double a, double b, double& x, double& y) {
+    double p = a * b;
+    y = fma(a, b, -p);
+    x = p;
+}
+
+// 把 b 精确加进展开式 e[0, n)（各分量按绝对值递增、互不重叠），省略为 0 的分量，返回新长度
+inline int growExpansion(double* e, int n, double b) {
+    double q = b;
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        double h;
+        twoSum(q, e[i], q, h);
+        if (h != 0) e[m++] = h;
+    }
+    if (q != 0) e[m++] = q;
+    return m;
+}
+
+// 精确计算 (a - c) x (b - c) 的符号：每个差拆成两项，8 个乘积再各拆成两项，累加成展开式后看最高分量
+int orient2dExact(double ax, double ay, double bx, double by, double cx, double cy) {
+    double acx, acxt, acy, acyt, bcx, bcxt, bcy, bcyt;
+    twoSum(ax, -cx, acx, acxt);
+    twoSum(ay, -cy, acy, acyt);
+    twoSum(bx, -cx, bcx, bcxt);
+    twoSum(by, -cy, bcy, bcyt);
+    const double left[4][2] = { { acx, bcy }, { acx, bcyt }, { acxt, bcy }, { acxt, bcyt } };
+    const double right[4][2] = { { acy, bcx }, { acy, bcxt }, { acyt, bcx }, { acyt, bcxt } };
+
+    double e[16];
+    int n = 0;
+    for (int k = 0; k < 4; k++) {
+        double x, y;
+        twoProduct(left[k][0], left[k][1], x, y);
+        n = growExpansion(e, n, y);
+        n = growExpansion(e, n, x);
+        twoProduct(right[k][0], right[k][1], x, y);
+        n = growExpansion(e, n, -y);
+        n = growExpansion(e, n, -x);
+    }
+    return n == 0 ? 0 : (e[n - 1] > 0 ? 1 : -1);
+}
+
+// 方向判定：c 在有向直线 ab 左侧（a→b→c 逆时针）返回 1，右侧返回 -1，三点共线返回 0
+// 先按浮点计算，结果超出误差界（Shewchuk 的 ccwerrboundA）即可直接定号；否则退回精确计算
+inline int orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    const double ERR_BOUND = 3.3306690738754716e-16;  // (3 + 16ε)ε，ε = 2^-53
+    double left = (ax - cx) * (by - cy);
+    double right = (ay - cy) * (bx - cx);
+    double det = left - right;
+    double bound = ERR_BOUND * (fabs(left) + fabs(right));
+    if (det > bound) return 1;
+    if (-det > bound) return -1;
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+template<typename T>
+inline int orientation(const Vec2<T>& a, const Vec2<T>& b, const Vec2<T>& c) {
+    return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+template<typename T>
+inline bool lessXY(const Vec2<T>& a, const Vec2<T>& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+// threads 为 0 时使用全部 CPU 核心，且不多于 count 个
+inline int resolveThreads(int threads, size_t count) {
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    return (int)max<size_t>(1, min<size_t>(threads, count));
+}
+
+// 把 [0, count) 均分成 threads 段，第 t 段在第 t 个线程中执行 body(begin, end, t)，第 0 段在当前线程
+template<typename Body>
+void parallelChunks(size_t count, int threads, Body body) {
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(body, count * t / threads, count * (t + 1) / threads, t);
+    }
+    body(0, count / threads, 0);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+// Andrew 单调链：pts 原地按 (x, y) 排序去重，返回逆时针凸包（从最左下的点开始，不含边上的共线点）
+template<typename T>
+vector<Vec2<T>> monotoneChain(vector<Vec2<T>>& pts) {
+    sort(pts.begin(), pts.end(), lessXY<T>);
+    pts.erase(unique(pts.begin(), pts.end(), [](const Vec2<T>& a, const Vec2<T>& b) {
+        return a.x == b.x && a.y == b.y;
+    }), pts.end());
+    size_t n = pts.size();
+    if (n < 3) return pts;
+
+    vector<Vec2<T>> hull(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {                      // 下凸壳
+        while (k >= 2 && orientation(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+    }
+    for (size_t i = n - 1, lower = k + 1; i-- > 0;) {     // 上凸壳
+        while (k >= lower && orientation(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+// 并行凸包：各线程先找本段在 8 个方向（每隔 45°）上最远的点，合并出全局的 8 个极点；
+// 严格落在极点八边形内部的点不可能在凸包上（Akl–Toussaint 过滤，圆盘内均匀分布时约剩 10%），
+// 各线程对本段剩余的点做单调链，最后把各段凸包的顶点合在一起再做一次单调链
+template<typename T>
+vector<Vec2<T>> convexHull(const Vec2<T>* pts, size_t n, int threads = 0) {
+    const int DIRS = 8;
+    const double DIR_X[DIRS] = { -1, -1, 0, 1, 1, 1, 0, -1 };  // 按角度递增，极点依次为逆时针顺序
+    const double DIR_Y[DIRS] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+    if (n == 0) return {};
+    threads = resolveThreads(threads, n);
+
+    vector<Vec2<T>> extremes(DIRS * threads);
+    parallelChunks(n, threads, [&](size_t begin, size_t end, int t) {
+        double best[DIRS];
+        for (int k = 0; k < DIRS; k++) {
+            extremes[DIRS * t + k] = pts[begin];
+            best[k] = DIR_X[k] * pts[begin].x + DIR_Y[k] * pts[begin].y;
+        }
+        for (size_t i = begin + 1; i < end; i++) {
+            for (int k = 0; k < DIRS; k++) {
+                double key = DIR_X[k] * pts[i].x + DIR_Y[k] * pts[i].y;
+                if (key > best[k]) {
+                    best[k] = key;
+                    extremes[DIRS * t + k] = pts[i];
+                }
+            }
+        }
+    });
+    Vec2<T> poly[DIRS];
+    for (int k = 0; k < DIRS; k++) {
+        poly[k] = extremes[k];
+        for (int t = 1; t < threads; t++) {
+            const Vec2<T>& p = extremes[DIRS * t + k];
+            if (DIR_X[k] * p.x + DIR_Y[k] * p.y > DIR_X[k] * poly[k].x + DIR_Y[k] * poly[k].y) poly[k] = p;
+        }
+    }
+
+    auto insidePolygon = [&](const Vec2<T>& p) {
+        for (int k = 0; k < DIRS; k++) {
+            if (orientation(poly[k], poly[(k + 1) % DIRS], p) <= 0) return false;
+        }
+        return true;
+    };
+    // 八边形内的轴对齐矩形：四个角都严格在八边形内时，矩形内部的点只要 4 次比较就能丢弃
+    T x0 = max(poly[1].x, poly[7].x), x1 = min(poly[3].x, poly[5].x);
+    T y0 = max(poly[1].y, poly[3].y), y1 = min(poly[5].y, poly[7].y);
+    bool useBox = x0 < x1 && y0 < y1 && insidePolygon(Vec2<T>{ x0, y0 }) && insidePolygon(Vec2<T>{ x1, y0 }) &&
+                  insidePolygon(Vec2<T>{ x1, y1 }) && insidePolygon(Vec2<T>{ x0, y1 });
+
+    vector<vector<Vec2<T>>> partial(threads);
+    parallelChunks(n, threads, [&](size_t begin, size_t end, int t) {
+        vector<Vec2<T>> candidates;
+        for (size_t i = begin; i < end; i++) {
+            const Vec2<T>& p = pts[i];
+            if (useBox && p.x > x0 && p.x < x1 && p.y > y0 && p.y < y1) continue;
+            if (!insidePolygon(p)) candidates.push_back(p);
+        }
+        partial[t] = monotoneChain(candidates);
+    });
+
+    vector<Vec2<T>> merged;
+    for (const auto& h : partial) {
+        merged.insert(merged.end(), h.begin(), h.end());
+    }
+    return monotoneChain(merged);
+}
+
+// 最近点对：两点在输入数组中的下标（first < second）与距离的平方
+struct ClosestPair {
+    size_t first, second;
+    double distance2;
+};
+
+// 分治过程中只搬动坐标，不带下标，每层归并少搬三分之一的数据；结束后再按坐标找回下标
+template<typename T>
+struct PairCandidate {
+    Vec2<T> a, b;
+    double distance2;
+};
+
+template<typename T>
+inline void updateClosest(PairCandidate<T>& best, const Vec2<T>& a, const Vec2<T>& b) {
+    double dx = (double)a.x - b.x, dy = (double)a.y - b.y;
+    double d2 = dx * dx + dy * dy;
+    if (d2 < best.distance2) {
+        best = { a, b, d2 };
+    }
 }
 
-void Shape::mirrorPointAround(Point& p, const Point& center, bool horizontal) {
-    if (horizontal) {
-        p.setY(2 * center.getY() - p.getY());
+// 分治求最近点对：a[0, n) 按 x 排序，返回时按 y 排好序的结果在 toBuf ? buf : a 中，另一个数组的内容作废
+// 子问题把结果写到与自己相反的数组里，归并时直接写回目标数组，省去每层一次整段复制
+// 只比较距离平方，不开方；depth > 0 时左半部分交给新线程，两半各自只用自己的区间，可并行
+template<typename T>
+PairCandidate<T> closestPairRec(Vec2<T>* a, Vec2<T>* buf, size_t n, bool toBuf, int depth) {
+    const size_t BASE = 16;
+    auto byY = [](const Vec2<T>& u, const Vec2<T>& v) { return u.y < v.y; };
+    PairCandidate<T> best = { a[0], a[0], numeric_limits<double>::infinity() };
+    if (n <= BASE) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = i + 1; j < n; j++) {
+                updateClosest(best, a[i], a[j]);
+            }
+        }
+        Vec2<T>* out = toBuf ? buf : a;
+        if (toBuf) copy(a, a + n, buf);
+        for (size_t i = 1; i < n; i++) {
+            Vec2<T> v = out[i];
+            size_t k = i;
+            for (; k > 0 && byY(v, out[k - 1]); k--) out[k] = out[k - 1];
+            out[k] = v;
+        }
+        return best;
+    }
+
+    size_t mid = n / 2;
+    double midX = a[mid].x;
+    PairCandidate<T> left, right;
+    if (depth > 0) {
+        thread worker([&] { left = closestPairRec(a, buf, mid, !toBuf, depth - 1); });
+        right = closestPairRec(a + mid, buf + mid, n - mid, !toBuf, depth - 1);
+        worker.join();
     } else {
-        p.setX(2 * center.getX() - p.getX());
+        left = closestPairRec(a, buf, mid, !toBuf, 0);
+        right = closestPairRec(a + mid, buf + mid, n - mid, !toBuf, 0);
+    }
+    best = left.distance2 <= right.distance2 ? left : right;
+
+    Vec2<T>* src = toBuf ? a : buf;
+    Vec2<T>* out = toBuf ? buf : a;
+    merge(src, src + mid, src + mid, src + n, out, byY);
+
+    // 跨越中线的点对只可能出现在宽 2δ 的竖条内，按 y 顺序每个点只需与后面 dy < δ 的点比较；竖条借用 src 存放
+    size_t strip = 0;
+    for (size_t i = 0; i < n; i++) {
+        double dx = out[i].x - midX;
+        if (dx * dx < best.distance2) src[strip++] = out[i];
+    }
+    for (size_t i = 0; i < strip; i++) {
+        for (size_t j = i + 1; j < strip; j++) {
+            double dy = (double)src[j].y - src[i].y;
+            if (dy * dy >= best.distance2) break;
+            updateClosest(best, src[i], src[j]);
+        }
+    }
+    return best;
+}
+
+// O(n log n) 最近点对：先分段并行按 x 排序再逐层归并，然后分治；前 log2(threads) 层递归并行
+template<typename T>
+ClosestPair closestPair(const Vec2<T>* pts, size_t n, int threads = 0) {
+    if (n < 2) throw invalid_argument("最近点对至少需要两个点");
+    threads = resolveThreads(threads, n);
+
+    vector<Vec2<T>> a(pts, pts + n), buf(n);
+    auto byX = [](const Vec2<T>& u, const Vec2<T>& v) { return u.x < v.x; };
+    parallelChunks(n, threads, [&](size_t begin, size_t end, int) {
+        sort(a.begin() + begin, a.begin() + end, byX);
+    });
+    for (int width = 1; width < threads; width *= 2) {
+        for (int t = 0; t + width < threads; t += 2 * width) {
+            size_t begin = n * t / threads;
+            size_t mid = n * (t + width) / threads;
+            size_t end = n * min(t + 2 * width, threads) / threads;
+            inplace_merge(a.begin() + begin, a.begin() + mid, a.begin() + end, byX);
+        }
+    }
+
+    int depth = 0;
+    while ((1 << (depth + 1)) <= threads) depth++;
+    PairCandidate<T> best = closestPairRec(a.data(), buf.data(), n, false, depth);
+
+    // 按坐标找回下标；两点重合时取不同的两个下标
+    auto same = [](const Vec2<T>& u, const Vec2<T>& v) { return u.x == v.x && u.y == v.y; };
+    size_t first = n, second = n;
+    for (size_t i = 0; i < n && (first == n || second == n); i++) {
+        if (first == n && same(pts[i], best.a)) first = i;
+        else if (second == n && same(pts[i], best.b)) second = i;
     }
+    return { min(first, second), max(first, second), best.distance2 };
 }
 
-void Shape::scalePointAround(Point& p, const Point& center, double factor) {
-    p.setX(center.getX() + (p.getX() - center.getX()) * factor);
-    p.setY(center.getY() + (p.getY() - center.getY()) * factor);
+// 近邻查询结果：点在原数组中的下标与到查询点距离的平方
+struct Neighbor {
+    size_t index;
+    double distance2;
+};
+
+inline bool closerNeighbor(const Neighbor& a, const Neighbor& b) {
+    return a.distance2 < b.distance2;
+}
+
+// 静态 k-d 树：不存节点，区间 [lo, hi) 的中点 mid 就是该节点的分割点，左右子树分别为 [lo, mid)、[mid + 1, hi)，
+// 深度为偶数时按 x 分割、奇数时按 y 分割；不超过 LEAF 个点的区间直接线性扫描
+// 坐标与原下标分开连续存放，遍历时只读坐标，命中后才取下标
+template<typename T>
+class KdTree {
+private:
+    static const size_t LEAF = 8;
+
+    struct Entry {
+        Vec2<T> p;
+        size_t id;
+    };
+
+    vector<Vec2<T>> points;
+    vector<size_t> ids;
+
+    static double axisValue(const Vec2<T>& p, int depth) { return (depth & 1) ? p.y : p.x; }
+
+    static double distance2(const Vec2<T>& a, const Vec2<T>& b) {
+        double dx = (double)a.x - b.x, dy = (double)a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+
+    // 前 parallelDepth 层的左子树交给新线程建，左右子树的区间不重叠
+    static void build(Entry* e, size_t lo, size_t hi, int depth, int parallelDepth) {
+        if (hi - lo <= LEAF) return;
+        size_t mid = lo + (hi - lo) / 2;
+        nth_element(e + lo, e + mid, e + hi, [depth](const Entry& a, const Entry& b) {
+            return axisValue(a.p, depth) < axisValue(b.p, depth);
+        });
+        if (depth < parallelDepth) {
+            thread worker(build, e, lo, mid, depth + 1, parallelDepth);
+            build(e, mid + 1, hi, depth + 1, parallelDepth);
+            worker.join();
+        } else {
+            build(e, lo, mid, depth + 1, parallelDepth);
+            build(e, mid + 1, hi, depth + 1, parallelDepth);
+        }
+    }
+
+    // heap 为按距离的大顶堆，最多 k 个；bound 为当前搜索半径的平方，堆满后随堆顶收缩
+    void offer(size_t i, const Vec2<T>& q, size_t k, vector<Neighbor>& heap, double& bound) const {
+        double d2 = distance2(points[i], q);
+        if (d2 > bound) return;
+        if (heap.size() == k) {
+            if (d2 >= heap.front().distance2) return;
+            pop_heap(heap.begin(), heap.end(), closerNeighbor);
+            heap.pop_back();
+        }
+        heap.push_back({ i, d2 });
+        push_heap(heap.begin(), heap.end(), closerNeighbor);
+        if (heap.size() == k) bound = min(bound, heap.front().distance2);
+    }
+
+    void searchNearest(size_t lo, size_t hi, int depth, const Vec2<T>& q, size_t k,
+                       vector<Neighbor>& heap, double& bound) const {
+        if (hi - lo <= LEAF) {
+            for (size_t i = lo; i < hi; i++) offer(i, q, k, heap, bound);
+            return;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        double diff = axisValue(q, depth) - axisValue(points[mid], depth);
+        if (diff < 0) {
+            searchNearest(lo, mid, depth + 1, q, k, heap, bound);
+            offer(mid, q, k, heap, bound);
+            if (diff * diff <= bound) searchNearest(mid + 1, hi, depth + 1, q, k, heap, bound);
+        } else {
+            searchNearest(mid + 1, hi, depth + 1, q, k, heap, bound);
+            offer(mid, q, k, heap, bound);
+            if (diff * diff <= bound) searchNearest(lo, mid, depth + 1, q, k, heap, bound);
+        }
+    }
+
+    void searchRadius(size_t lo, size_t hi, int depth, const Vec2<T>& q, double r2, vector<size_t>& out) const {
+        if (hi - lo <= LEAF) {
+            for (size_t i = lo; i < hi; i++) {
+                if (distance2(points[i], q) <= r2) out.push_back(ids[i]);
+            }
+            return;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        double diff = axisValue(q, depth) - axisValue(points[mid], depth);
+        if (distance2(points[mid], q) <= r2) out.push_back(ids[mid]);
+        if (diff <= 0 || diff * diff <= r2) searchRadius(lo, mid, depth + 1, q, r2, out);
+        if (diff >= 0 || diff * diff <= r2) searchRadius(mid + 1, hi, depth + 1, q, r2, out);
+    }
+
+    void searchBox(size_t lo, size_t hi, int depth, const Vec2<T>& low, const Vec2<T>& high, vector<size_t>& out) const {
+        auto inside = [&](const Vec2<T>& p) { return p.x >= low.x && p.x <= high.x && p.y >= low.y && p.y <= high.y; };
+        if (hi - lo <= LEAF) {
+            for (size_t i = lo; i < hi; i++) {
+                if (inside(points[i])) out.push_back(ids[i]);
+            }
+            return;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        double split = axisValue(points[mid], depth);
+        if (inside(points[mid])) out.push_back(ids[mid]);
+        if (axisValue(low, depth) <= split) searchBox(lo, mid, depth + 1, low, high, out);
+        if (axisValue(high, depth) >= split) searchBox(mid + 1, hi, depth + 1, low, high, out);
+    }
+
+    // 从堆中取出结果，按距离升序写入 out，并把内部位置换成原下标
+    void finish(vector<Neighbor>& heap, Neighbor* out) const {
+        sort_heap(heap.begin(), heap.end(), closerNeighbor);
+        for (size_t j = 0; j < heap.size(); j++) {
+            out[j] = { ids[heap[j].index], heap[j].distance2 };
+        }
+    }
+
+public:
+    // threads 为 0 时使用全部 CPU 核心
+    KdTree(const Vec2<T>* pts, size_t n, int threads = 0) : points(n), ids(n) {
+        vector<Entry> entries(n);
+        for (size_t i = 0; i < n; i++) {
+            entries[i] = { pts[i], i };
+        }
+        threads = resolveThreads(threads, n);
+        int parallelDepth = 0;
+        while ((1 << (parallelDepth + 1)) <= threads) parallelDepth++;
+        build(entries.data(), 0, n, 0, parallelDepth);
+        for (size_t i = 0; i < n; i++) {
+            points[i] = entries[i].p;
+            ids[i] = entries[i].id;
+        }
+    }
+
+    size_t size() const { return points.size(); }
+
+    // 距 q 最近的 k 个点（不足 k 个时返回全部），按距离从小到大
+    vector<Neighbor> nearest(const Vec2<T>& q, size_t k) const {
+        k = min(k, points.size());
+        vector<Neighbor> heap, result(k);
+        if (k == 0) return result;
+        heap.reserve(k);
+        double bound = numeric_limits<double>::infinity();
+        searchNearest(0, points.size(), 0, q, k, heap, bound);
+        finish(heap, result.data());
+        return result;
+    }
+
+    // 把与 q 距离不超过 r 的点的下标追加到 out（无序）
+    void radius(const Vec2<T>& q, double r, vector<size_t>& out) const {
+        if (!points.empty()) searchRadius(0, points.size(), 0, q, r * r, out);
+    }
+
+    // 把落在闭矩形 [low, high] 内的点的下标追加到 out（无序）
+    void box(const Vec2<T>& low, const Vec2<T>& high, vector<size_t>& out) const {
+        if (!points.empty()) searchBox(0, points.size(), 0, low, high, out);
+    }
+
+    // 批量 k 近邻，第 i 个查询的结果按距离升序写入 out[i * k', (i + 1) * k')，k' = min(k, size())
+    // 查询先按 z 序（Morton 码）排列，相邻查询在空间上相近，访问的节点多半还在缓存里；
+    // 每个查询以能包住上一个查询全部 k' 个结果的距离为初始半径，真正的 k' 近邻一定在其中，结果不受影响，剪枝却从第一步就生效
+    void nearestBatch(const Vec2<T>* queries, size_t m, size_t k, vector<Neighbor>& out, int threads = 0) const {
+        k = min(k, points.size());
+        out.assign(m * k, Neighbor{ 0, 0 });
+        if (m == 0 || k == 0) return;
+
+        double minX = queries[0].x, maxX = minX, minY = queries[0].y, maxY = minY;
+        for (size_t i = 1; i < m; i++) {
+            minX = min(minX, (double)queries[i].x);
+            maxX = max(maxX, (double)queries[i].x);
+            minY = min(minY, (double)queries[i].y);
+            maxY = max(maxY, (double)queries[i].y);
+        }
+        double sx = maxX > minX ? 65535.0 / (maxX - minX) : 0, sy = maxY > minY ? 65535.0 / (maxY - minY) : 0;
+        auto spread = [](uint32_t v) {  // 16 位数的各位之间插入一个 0
+            v = (v | (v << 8)) & 0x00FF00FFu;
+            v = (v | (v << 4)) & 0x0F0F0F0Fu;
+            v = (v | (v << 2)) & 0x33333333u;
+            v = (v | (v << 1)) & 0x55555555u;
+            return v;
+        };
+        vector<pair<uint32_t, size_t>> order(m);
+        for (size_t i = 0; i < m; i++) {
+            uint32_t gx = (uint32_t)((queries[i].x - minX) * sx), gy = (uint32_t)((queries[i].y - minY) * sy);
+            order[i] = { spread(gx) | (spread(gy) << 1), i };
+        }
+        sort(order.begin(), order.end());
+
+        threads = resolveThreads(threads, m);
+        parallelChunks(m, threads, [&](size_t begin, size_t end, int) {
+            vector<Neighbor> heap;
+            heap.reserve(k);
+            const Vec2<T>* previous = nullptr;
+            double previousFar = 0;  // 上一个查询第 k' 近的距离平方
+            for (size_t j = begin; j < end; j++) {
+                size_t qi = order[j].second;
+                const Vec2<T>& q = queries[qi];
+                double bound = numeric_limits<double>::infinity();
+                if (previous) {
+                    // 三角不等式：上一个查询的结果到 q 的距离不超过 |q - previous| + sqrt(previousFar)，乘一点余量抵消舍入
+                    double reach = sqrt(distance2(q, *previous)) + sqrt(previousFar);
+                    bound = reach * reach * (1 + 1e-9);
+                }
+                heap.clear();
+                searchNearest(0, points.size(), 0, q, k, heap, bound);
+                finish(heap, &out[qi * k]);
+                previous = &q;
+                previousFar = out[qi * k + k - 1].distance2;
+            }
+        });
+    }
+};
+
+void Shape::rotatePointAround(Vertex& p, const Vertex& center, double angle) {
+    Affine2D::rotationAround(center, angle).apply(p);
+}
+
+void Shape::mirrorPointAround(Vertex& p, const Vertex& center, bool horizontal) {
+    Affine2D::mirrorAround(center, horizontal).apply(p);
+}
+
+void Shape::scalePointAround(Vertex& p, const Vertex& center, double factor) {
+    Affine2D::scalingAround(center, factor).apply(p);
 }
 
 class LineSegment : public Shape {
  private:
-     Point p1, p2;
+     Vertex p1, p2;
      static int instanceCount;
  
-     Point getCenter() const {
-         return Point((p1.getX() + p2.getX()) / 2, (p1.getY() + p2.getY()) / 2);
+     Vertex getCenter() const {
+         return makeVertex(((double)p1.x + p2.x) / 2, ((double)p1.y + p2.y) / 2);
      }
  
  public:
-     LineSegment(const Point& pt1, const Point& pt2) : p1(pt1), p2(pt2) { ++instanceCount; }
+     TRACE_TYPE(LineSegment)
+
+     LineSegment(const Point& pt1, const Point& pt2) : p1(pt1.position()), p2(pt2.position()) { ++instanceCount; }
      LineSegment(double x1, double y1, double x2, double y2)
-         : p1(x1, y1), p2(x2, y2) {
+         : p1(makeVertex(x1, y1)), p2(makeVertex(x2, y2)) {
          ++instanceCount;
      }
      ~LineSegment() override { --instanceCount; }
 
      static int getInstanceCount() { return instanceCount; }
  
-     double getArea() const override { return 0; }
+     double getArea() const override { TRACE_CALL(GetArea); return 0; }
 
      double getPerimeter() const override {
          return p1.distanceTo(p2);
      }
  
-     void draw(color_t color) const override {
-         setcolor(color);
-         setlinewidth(2);
-         line((int)p1.getX(), (int)p1.getY(), (int)p2.getX(), (int)p2.getY());
-         p1.draw(color);
-         p2.draw(color);
+     void draw(RenderQueue& queue, color_t color) const override {
+         TRACE_CALL(Draw);
+         queue.addLine((int)p1.x, (int)p1.y, (int)p2.x, (int)p2.y, color, 2);
+         drawVertex(queue, p1, color);
+         drawVertex(queue, p2, color);
      }
 
     void rotate(double angle) override {
-        Point center = getCenter();
+        TRACE_CALL(Rotate);
+        Vertex center = getCenter();
         rotatePointAround(p1, center, angle);
         rotatePointAround(p2, center, angle);
     }
 
     void mirror(bool horizontal) override {
-        Point center = getCenter();
+        TRACE_CALL(Mirror);
+        Vertex center = getCenter();
         mirrorPointAround(p1, center, horizontal);
         mirrorPointAround(p2, center, horizontal);
     }
 
     void scale(double factor) override {
-        Point center = getCenter();
+        TRACE_CALL(Scale);
+        Vertex center = getCenter();
         scalePointAround(p1, center, factor);
         scalePointAround(p2, center, factor);
     }
  
      void move(double dx, double dy) override {
-         p1.move(dx, dy);
-         p2.move(dx, dy);
+         TRACE_CALL(Move);
+         p1 = makeVertex(p1.x + dx, p1.y + dy);
+         p2 = makeVertex(p2.x + dx, p2.y + dy);
      }
  
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
-        oss << "线段" << " 从 (" << p1.getX() << ", " << p1.getY()
-            << ") 到 (" << p2.getX() << ", " << p2.getY() << ")";
+        oss << "线段" << " 从 (" << p1.x << ", " << p1.y
+            << ") 到 (" << p2.x << ", " << p2.y << ")";
         oss << " | 面积: 0";
         oss << " | 周长: " << getPerimeter();
         return oss.str();
     }
+
+    void appendVertices(vector<double>& xs, vector<double>& ys) const override {
+        xs.insert(xs.end(), { (double)p1.x, (double)p2.x });
+        ys.insert(ys.end(), { (double)p1.y, (double)p2.y });
+    }
  };
  
 class Circle : public Shape {
  private:
-     Point center;
+     Vertex center;
      double radius;
      static int instanceCount;
  
  public:
-     Circle(const Point& c, double r) : center(c), radius(r) { ++instanceCount; }
-     Circle(double x, double y, double r) : center(x, y), radius(r) { ++instanceCount; }
+     TRACE_TYPE(Circle)
+
+     Circle(const Point& c, double r) : center(c.position()), radius(r) { ++instanceCount; }
+     Circle(double x, double y, double r) : center(makeVertex(x, y)), radius(r) { ++instanceCount; }
      ~Circle() override { --instanceCount; }
 
      static int getInstanceCount() { return instanceCount; }
  
      double getArea() const override {
+         TRACE_CALL(GetArea);
          return MY_PI * radius * radius;
      }
  
@@ -232,55 +947,70 @@ class Circle : public Shape {
          return 2 * MY_PI * radius;
      }
  
-     void draw(color_t color) const override {
-         setcolor(color);
-         setlinewidth(2);
-         circle((int)center.getX(), (int)center.getY(), (int)radius);
-         center.draw(color);
+     void draw(RenderQueue& queue, color_t color) const override {
+         TRACE_CALL(Draw);
+         queue.addCircle((int)center.x, (int)center.y, (int)radius, color, 2);
+         drawVertex(queue, center, color);
      }
 
      void rotate(double angle) override {
+         TRACE_CALL(Rotate);
      }
 
      void mirror(bool horizontal) override {
-         Point origin(0, 0);
+         TRACE_CALL(Mirror);
+         Vertex origin = { 0, 0 };
          mirrorPointAround(center, origin, horizontal);
      }
  
      void scale(double factor) override {
+         TRACE_CALL(Scale);
          radius *= factor;
      }
  
      void move(double dx, double dy) override {
-         center.move(dx, dy);
+         TRACE_CALL(Move);
+         center = makeVertex(center.x + dx, center.y + dy);
      }
  
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
-        oss << "圆" << " 位于 (" << center.getX() << ", " << center.getY()
+        oss << "圆" << " 位于 (" << center.x << ", " << center.y
             << ") 半径 " << radius;
         oss << " | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
     }
+
+    void appendVertices(vector<double>& xs, vector<double>& ys) const override {
+        xs.push_back(center.x);
+        ys.push_back(center.y);
+    }
  };
  
 class Rect : public Shape {
  private:
-     Point topLeft;
+     Vertex topLeft;
      double width, height;
      static int instanceCount;
  
-     Point getCenter() const {
-         return Point(topLeft.getX() + width / 2, topLeft.getY() + height / 2);
+     Vertex getCenter() const {
+         return makeVertex(topLeft.x + width / 2, topLeft.y + height / 2);
+     }
+
+     void setCenter(const Vertex& center) {
+         topLeft = makeVertex(center.x - width / 2, center.y - height / 2);
      }
  
  public:
+     TRACE_TYPE(Rect)
+
      Rect(const Point& tl, double w, double h)
-         : topLeft(tl), width(w), height(h) {
+         : topLeft(tl.position()), width(w), height(h) {
          ++instanceCount;
      }
      Rect(double x, double y, double w, double h)
-         : topLeft(x, y), width(w), height(h) {
+         : topLeft(makeVertex(x, y)), width(w), height(h) {
          ++instanceCount;
      }
      ~Rect() override { --instanceCount; }
@@ -288,6 +1018,7 @@ class Rect : public Shape {
      static int getInstanceCount() { return instanceCount; }
  
      double getArea() const override {
+         TRACE_CALL(GetArea);
          return width * height;
      }
  
@@ -295,19 +1026,19 @@ class Rect : public Shape {
          return 2 * (width + height);
      }
  
-     void draw(color_t color) const override {
-         setcolor(color);
-         setlinewidth(2);
-         rectangle((int)topLeft.getX(), (int)topLeft.getY(),
-             (int)(topLeft.getX() + width), (int)(topLeft.getY() + height));
-         topLeft.draw(color);
-         Point(topLeft.getX() + width, topLeft.getY()).draw(color);
-         Point(topLeft.getX(), topLeft.getY() + height).draw(color);
-         Point(topLeft.getX() + width, topLeft.getY() + height).draw(color);
+     void draw(RenderQueue& queue, color_t color) const override {
+         TRACE_CALL(Draw);
+         queue.addRectangle((int)topLeft.x, (int)topLeft.y,
+             (int)(topLeft.x + width), (int)(topLeft.y + height), color, 2);
+         drawVertex(queue, topLeft, color);
+         drawVertex(queue, makeVertex(topLeft.x + width, topLeft.y), color);
+         drawVertex(queue, makeVertex(topLeft.x, topLeft.y + height), color);
+         drawVertex(queue, makeVertex(topLeft.x + width, topLeft.y + height), color);
      }
 
     void rotate(double angle) override {
-        Point center = getCenter();
+        TRACE_CALL(Rotate);
+        Vertex center = getCenter();
         double normalizedAngle = fmod(angle, 360.0);
         if (normalizedAngle < 0) normalizedAngle += 360.0;
 
@@ -321,64 +1052,73 @@ class Rect : public Shape {
             double temp = width;
             width = height;
             height = temp;
-            topLeft.setX(center.getX() - width / 2);
-            topLeft.setY(center.getY() - height / 2);
+            setCenter(center);
         }
         else if (fabs(normalizedAngle - ANGLE_180) < ANGLE_TOLERANCE) {
-            topLeft.setX(center.getX() - width / 2);
-            topLeft.setY(center.getY() - height / 2);
+            setCenter(center);
         }
      }
 
      void mirror(bool horizontal) override {
-         Point center = getCenter();
+         TRACE_CALL(Mirror);
+         Vertex center = getCenter();
          if (horizontal) {
-             double newY = 2 * center.getY() - topLeft.getY() - height;
-             topLeft.setY(newY);
+             double newY = 2.0 * center.y - topLeft.y - height;
+             topLeft.y = (VertexScalar)newY;
          } else {
-             double newX = 2 * center.getX() - topLeft.getX() - width;
-             topLeft.setX(newX);
+             double newX = 2.0 * center.x - topLeft.x - width;
+             topLeft.x = (VertexScalar)newX;
          }
      }
  
      void scale(double factor) override {
-         Point center = getCenter();
+         TRACE_CALL(Scale);
+         Vertex center = getCenter();
          width *= factor;
          height *= factor;
-         topLeft.setX(center.getX() - width / 2);
-         topLeft.setY(center.getY() - height / 2);
+         setCenter(center);
      }
  
      void move(double dx, double dy) override {
-         topLeft.move(dx, dy);
+         TRACE_CALL(Move);
+         topLeft = makeVertex(topLeft.x + dx, topLeft.y + dy);
      }
  
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
-        oss << "矩形" << " 位于 (" << topLeft.getX() << ", " << topLeft.getY()
+        oss << "矩形" << " 位于 (" << topLeft.x << ", " << topLeft.y
             << ") 宽度 " << width << " 高度 " << height;
         oss << " | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
     }
+
+    void appendVertices(vector<double>& xs, vector<double>& ys) const override {
+        double x = topLeft.x, y = topLeft.y;
+        xs.insert(xs.end(), { x, x + width, x + width, x });
+        ys.insert(ys.end(), { y, y, y + height, y + height });
+    }
  };
  
 class Triangle : public Shape {
  private:
-     Point p1, p2, p3;
+     Vertex p1, p2, p3;
      static int instanceCount;
  
-     Point getCenter() const {
-         return Point((p1.getX() + p2.getX() + p3.getX()) / 3,
-                      (p1.getY() + p2.getY() + p3.getY()) / 3);
+     Vertex getCenter() const {
+         return makeVertex(((double)p1.x + p2.x + p3.x) / 3,
+                           ((double)p1.y + p2.y + p3.y) / 3);
      }
  
  public:
+     TRACE_TYPE(Triangle)
+
      Triangle(const Point& pt1, const Point& pt2, const Point& pt3)
-         : p1(pt1), p2(pt2), p3(pt3) {
+         : p1(pt1.position()), p2(pt2.position()), p3(pt3.position()) {
          ++instanceCount;
      }
      Triangle(double x1, double y1, double x2, double y2, double x3, double y3)
-         : p1(x1, y1), p2(x2, y2), p3(x3, y3) {
+         : p1(makeVertex(x1, y1)), p2(makeVertex(x2, y2)), p3(makeVertex(x3, y3)) {
          ++instanceCount;
      }
      ~Triangle() override { --instanceCount; }
@@ -386,60 +1126,69 @@ class Triangle : public Shape {
      static int getInstanceCount() { return instanceCount; }
  
      double getArea() const override {
-         return fabs((p1.getX() * (p2.getY() - p3.getY()) +
-             p2.getX() * (p3.getY() - p1.getY()) +
-             p3.getX() * (p1.getY() - p2.getY())) / 2.0);
+         TRACE_CALL(GetArea);
+         double x1 = p1.x, y1 = p1.y, x2 = p2.x, y2 = p2.y, x3 = p3.x, y3 = p3.y;
+         return fabs((x1 * (y2 - y3) + x2 * (y3 - y1) + x3 * (y1 - y2)) / 2.0);
      }
  
      double getPerimeter() const override {
          return p1.distanceTo(p2) + p2.distanceTo(p3) + p3.distanceTo(p1);
      }
  
-     void draw(color_t color) const override {
-         setcolor(color);
-         setlinewidth(2);
-         line((int)p1.getX(), (int)p1.getY(), (int)p2.getX(), (int)p2.getY());
-         line((int)p2.getX(), (int)p2.getY(), (int)p3.getX(), (int)p3.getY());
-         line((int)p3.getX(), (int)p3.getY(), (int)p1.getX(), (int)p1.getY());
-         p1.draw(color);
-         p2.draw(color);
-         p3.draw(color);
+     void draw(RenderQueue& queue, color_t color) const override {
+         TRACE_CALL(Draw);
+         queue.addLine((int)p1.x, (int)p1.y, (int)p2.x, (int)p2.y, color, 2);
+         queue.addLine((int)p2.x, (int)p2.y, (int)p3.x, (int)p3.y, color, 2);
+         queue.addLine((int)p3.x, (int)p3.y, (int)p1.x, (int)p1.y, color, 2);
+         drawVertex(queue, p1, color);
+         drawVertex(queue, p2, color);
+         drawVertex(queue, p3, color);
      }
 
     void rotate(double angle) override {
-        Point center = getCenter();
+        TRACE_CALL(Rotate);
+        Vertex center = getCenter();
         rotatePointAround(p1, center, angle);
         rotatePointAround(p2, center, angle);
         rotatePointAround(p3, center, angle);
     }
 
     void mirror(bool horizontal) override {
-        Point center = getCenter();
+        TRACE_CALL(Mirror);
+        Vertex center = getCenter();
         mirrorPointAround(p1, center, horizontal);
         mirrorPointAround(p2, center, horizontal);
         mirrorPointAround(p3, center, horizontal);
     }
 
     void scale(double factor) override {
-        Point center = getCenter();
+        TRACE_CALL(Scale);
+        Vertex center = getCenter();
         scalePointAround(p1, center, factor);
         scalePointAround(p2, center, factor);
         scalePointAround(p3, center, factor);
     }
  
      void move(double dx, double dy) override {
-         p1.move(dx, dy);
-         p2.move(dx, dy);
-         p3.move(dx, dy);
+         TRACE_CALL(Move);
+         p1 = makeVertex(p1.x + dx, p1.y + dy);
+         p2 = makeVertex(p2.x + dx, p2.y + dy);
+         p3 = makeVertex(p3.x + dx, p3.y + dy);
      }
  
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
-        oss << "三角形" << " 顶点: (" << p1.getX() << ", " << p1.getY() << "), ("
-            << p2.getX() << ", " << p2.getY() << "), (" << p3.getX() << ", " << p3.getY() << ")";
+        oss << "三角形" << " 顶点: (" << p1.x << ", " << p1.y << "), ("
+            << p2.x << ", " << p2.y << "), (" << p3.x << ", " << p3.y << ")";
         oss << " | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
     }
+
+    void appendVertices(vector<double>& xs, vector<double>& ys) const override {
+        xs.insert(xs.end(), { (double)p1.x, (double)p2.x, (double)p3.x });
+        ys.insert(ys.end(), { (double)p1.y, (double)p2.y, (double)p3.y });
+    }
  };
  
 int Point::instanceCount = 0;
@@ -448,6 +1197,72 @@ int Circle::instanceCount = 0;
 int Rect::instanceCount = 0;
 int Triangle::instanceCount = 0;
 
+// 实例化图形：每个实例的局部顶点只保存一份，每帧批量组合矩阵后一次性算出全部世界坐标
+class ShapeInstances {
+private:
+    vector<double> localX, localY;
+    vector<double> worldX, worldY;
+    vector<size_t> offsets;
+    vector<Affine2D> transforms;
+
+public:
+    ShapeInstances() : offsets(1, 0) {}
+
+    // 以 shape 的当前顶点作为局部坐标添加一个实例，返回实例编号
+    size_t add(const Shape& shape, const Affine2D& transform = Affine2D::identity()) {
+        shape.appendVertices(localX, localY);
+        offsets.push_back(localX.size());
+        transforms.push_back(transform);
+        worldX.resize(localX.size());
+        worldY.resize(localY.size());
+        return transforms.size() - 1;
+    }
+
+    size_t size() const { return transforms.size(); }
+    size_t vertexCount() const { return localX.size(); }
+
+    Affine2D& transform(size_t i) { return transforms[i]; }
+    const Affine2D& transform(size_t i) const { return transforms[i]; }
+
+    // 每个实例在当前变换之后再做 delta[i]
+    void composeAll(const Affine2D* delta) {
+        composeAffine(delta, transforms.data(), transforms.data(), transforms.size());
+    }
+
+    // 所有实例在当前变换之后再做同一个 delta
+    void composeAll(const Affine2D& delta) {
+        for (auto& t : transforms) t = delta * t;
+    }
+
+    // 用各实例的矩阵重新计算世界坐标
+    void update() {
+        applyAffine(transforms.data(), offsets.data(), transforms.size(),
+            localX.data(), localY.data(), worldX.data(), worldY.data());
+    }
+
+    // 把世界坐标中的点变回第 i 个实例的局部坐标（如拾取判断），矩阵奇异时返回 false
+    bool toLocal(size_t i, Point& p) const {
+        Affine2D inv;
+        if (!transforms[i].inverse(inv)) return false;
+        inv.apply(p);
+        return true;
+    }
+
+    size_t vertexBegin(size_t i) const { return offsets[i]; }
+    size_t vertexEnd(size_t i) const { return offsets[i + 1]; }
+    const double* xs() const { return worldX.data(); }
+    const double* ys() const { return worldY.data(); }
+
+    // 画出第 i 个实例（按顶点顺序连成闭合折线）
+    void draw(RenderQueue& queue, size_t i, color_t color) const {
+        size_t first = offsets[i], last = offsets[i + 1];
+        for (size_t k = first; k < last; k++) {
+            size_t next = k + 1 < last ? k + 1 : first;
+            queue.addLine((int)worldX[k], (int)worldY[k], (int)worldX[next], (int)worldY[next], color, 2);
+        }
+    }
+};
+
  void drawText(int x, int y, const string& text, color_t color = WHITE) {
      setcolor(color);
      setfont(16, 0, "宋体");
@@ -460,10 +1275,394 @@ int Triangle::instanceCount = 0;
      outtextxy(20, y, title.c_str());
  }
 
- int main() {
+// 性能测试（main --bench）：10^5 个三角形每帧旋转，逐个虚函数变换与批量仿射变换对比
+void benchAffine() {
+    TRACE_SPAN("benchAffine");
+    const int COUNT = 100000;
+    const int FRAMES = 60;
+    cout << "[批量仿射变换] " << COUNT << " 个三角形实例, " << FRAMES << " 帧" << endl;
+
+    vector<Shape*> shapes;
+    ShapeInstances instances;
+    vector<Affine2D> delta;
+    for (int i = 0; i < COUNT; i++) {
+        double x = (i % 400) * 3.0, y = (i / 400) * 3.0;
+        Shape* s = new Triangle(x, y, x + 2, y, x + 1, y + 2);
+        shapes.push_back(s);
+        instances.add(*s);
+        delta.push_back(Affine2D::rotationAround(makeVertex(x + 1, y + 1), 1.0 + i % 5));
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < COUNT; i++) {
+            shapes[i]->rotate(1.0 + i % 5);
+        }
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        instances.composeAll(delta.data());
+        instances.update();
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    vector<Affine2D> inv(COUNT), check(COUNT);
+    for (int i = 0; i < COUNT; i++) inv[i] = instances.transform(i);
+    size_t singular = invertAffine(inv.data(), inv.data(), COUNT);
+    for (int i = 0; i < COUNT; i++) check[i] = instances.transform(i);
+    composeAffine(inv.data(), check.data(), check.data(), COUNT);
+    auto t3 = chrono::steady_clock::now();
+
+    // 逆矩阵校验：inv * M 应为单位矩阵；第一个三角形的首个顶点应回到局部坐标
+    double maxErr = 0;
+    for (const Affine2D& m : check) {
+        maxErr = max(maxErr, max(fabs(m.a - 1) + fabs(m.b) + fabs(m.tx), fabs(m.c) + fabs(m.d - 1) + fabs(m.ty)));
+    }
+    Point p(instances.xs()[0], instances.ys()[0]);
+    instances.toLocal(0, p);
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    double vertices = (double)instances.vertexCount() * FRAMES;
+    cout << "逐个 rotate(): " << ms(t0, t1) / FRAMES << " ms/帧, "
+         << vertices / (ms(t0, t1) * 1e3) << " M顶点/s" << endl;
+    cout << "批量组合+变换: " << ms(t1, t2) / FRAMES << " ms/帧, "
+         << vertices / (ms(t1, t2) * 1e3) << " M顶点/s" << endl;
+    cout << "批量求逆+组合: " << ms(t2, t3) << " ms, 奇异矩阵 " << singular
+         << ", 最大误差 " << maxErr << ", 顶点还原 (" << p.getX() << ", " << p.getY() << ")" << endl;
+
+    for (auto shape : shapes) {
+        delete shape;
+    }
+}
+
+// 同一批顶点分别以 float、double 保存，每帧整体旋转一次
+template<typename T>
+double benchVertexTransform(size_t count, int frames) {
+    vector<Vec2<T>> vertices(count);
+    for (size_t i = 0; i < count; i++) {
+        vertices[i] = { (T)(i % 1000), (T)(i / 1000 % 1000) };
+    }
+    Affine2D m = Affine2D::rotationAround(Vec2<double>{ 500, 500 }, 0.5);
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        transformVertices(m, vertices.data(), vertices.size());
+    }
+    auto t1 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t1 - t0).count();
+    double mVertices = (double)count * frames / (ms * 1e3);
+    cout << (sizeof(T) == sizeof(float) ? "float " : "double") << " 顶点: " << sizeof(Vec2<T>) << " 字节/顶点, "
+         << mVertices << " M顶点/s, " << mVertices * 1e6 * sizeof(Vec2<T>) * 2 / 1e9 << " GB/s (读+写)"
+         << ", 首个顶点 (" << vertices[0].x << ", " << vertices[0].y << ")" << endl;
+    return mVertices;
+}
+
+// 性能测试（main --bench）：顶点精度对每个图形占用字节数与变换吞吐量的影响
+void benchVertexPrecision() {
+    TRACE_SPAN("benchVertexPrecision");
+    cout << "[顶点精度] 当前编译为 " << (sizeof(VertexScalar) == sizeof(float) ? "float" : "double")
+         << " 顶点（定义 SHAPE_FLOAT_VERTICES 切换）" << endl;
+    cout << "每个图形字节数: 点 " << sizeof(Point) << ", 线段 " << sizeof(LineSegment) << ", 圆 " << sizeof(Circle)
+         << ", 矩形 " << sizeof(Rect) << ", 三角形 " << sizeof(Triangle)
+         << "; 若顶点仍为 Point 对象, 三角形需 " << sizeof(void*) + 3 * sizeof(Point) << " 字节" << endl;
+
+    const size_t COUNT = 4000000;
+    const int FRAMES = 20;
+    double f = benchVertexTransform<float>(COUNT, FRAMES);
+    double d = benchVertexTransform<double>(COUNT, FRAMES);
+    cout << "float / double 吞吐量: " << f / d << endl;
+}
+
+// 性能测试（main --bench）：逐个图形立即提交（原 draw() 的做法）与整帧排序合并后提交的对比
+// 无窗口时用计数后端，只统计状态切换与调用次数，耗时为记录 + 排序 + 提交的 CPU 时间
+void benchRenderQueue() {
+    TRACE_SPAN("benchRenderQueue");
+    const int COUNT = 20000;
+    const int FRAMES = 30;
+    const color_t PALETTE[] = { WHITE, RED, YELLOW, LIGHTGREEN, LIGHTCYAN, EGERGB(255, 128, 0), EGERGB(128, 0, 255), EGERGB(0, 128, 255) };
+    const int COLORS = sizeof(PALETTE) / sizeof(PALETTE[0]);
+
+    vector<Shape*> shapes;
+    vector<color_t> colors;
+    for (int i = 0; i < COUNT; i++) {
+        double x = (i % 200) * 6.0, y = (i / 200) * 8.0;
+        switch (i % 4) {
+        case 0: shapes.push_back(new LineSegment(x, y, x + 5, y + 4)); break;
+        case 1: shapes.push_back(new Circle(x, y, 3)); break;
+        case 2: shapes.push_back(new Rect(x, y, 5, 4)); break;
+        default: shapes.push_back(new Triangle(x, y, x + 5, y, x + 2, y + 4)); break;
+        }
+        colors.push_back(PALETTE[(i * 7) % COLORS]);
+    }
+    cout << "[绘制命令队列] " << COUNT << " 个图形, " << COLORS << " 种颜色, " << FRAMES << " 帧, sizeof(DrawCommand) = "
+         << sizeof(DrawCommand) << endl;
+
+    RenderQueue queue;
+    CountingBackend immediate, batched;
+    RenderStats before, after;
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < COUNT; i++) {
+            shapes[i]->draw(queue, colors[i]);
+            RenderStats st = queue.flush(immediate, false);
+            before.primitives += st.primitives;
+            before.stateChanges += st.stateChanges;
+            before.batches += st.batches;
+        }
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < COUNT; i++) {
+            shapes[i]->draw(queue, colors[i]);
+        }
+        RenderStats st = queue.flush(batched);
+        after.primitives += st.primitives;
+        after.stateChanges += st.stateChanges;
+        after.batches += st.batches;
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cout << "逐个提交: " << before.primitives / FRAMES << " 图元/帧, 状态切换 " << before.stateChanges / FRAMES
+         << " 次/帧, 后端调用 " << immediate.calls / FRAMES << " 次/帧, " << ms(t0, t1) / FRAMES << " ms/帧" << endl;
+    cout << "分桶合并: " << after.primitives / FRAMES << " 图元/帧, 状态切换 " << after.stateChanges / FRAMES
+         << " 次/帧, 后端调用 " << batched.calls / FRAMES << " 次/帧, " << ms(t1, t2) / FRAMES << " ms/帧, "
+         << after.batches / FRAMES << " 批" << endl;
+
+    for (auto shape : shapes) {
+        delete shape;
+    }
+}
+
+// 性能测试（main --bench）：圆盘内均匀分布的 10^7 个点，凸包与最近点对在不同线程数下的耗时
+// 另用小规模点集与逐对比较、单线程单调链对照结果，并统计近共线点上朴素浮点判定出错的次数
+void benchGeometry() {
+    TRACE_SPAN("benchGeometry");
+    const size_t COUNT = 10000000;
+    const int hw = max(1, (int)thread::hardware_concurrency());
+    cout << "[点集几何] " << COUNT << " 个点, CPU 核心数 " << hw << endl;
+
+    mt19937 rng(7);
+    uniform_real_distribution<double> unit(0, 1);
+    vector<Vec2<double>> cloud(COUNT);
+    for (auto& p : cloud) {
+        double r = 5e5 * sqrt(unit(rng)), t = 2 * MY_PI * unit(rng);
+        p = { 5e5 + r * cos(t), 5e5 + r * sin(t) };
+    }
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    vector<int> threadCounts;
+    for (int t = 1; t < hw; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+    double hull1 = 0, pair1 = 0;
+    for (int threads : threadCounts) {
+        auto t0 = chrono::steady_clock::now();
+        vector<Vec2<double>> hull = convexHull(cloud.data(), cloud.size(), threads);
+        auto t1 = chrono::steady_clock::now();
+        ClosestPair cp = closestPair(cloud.data(), cloud.size(), threads);
+        auto t2 = chrono::steady_clock::now();
+        if (threads == 1) {
+            hull1 = ms(t0, t1);
+            pair1 = ms(t1, t2);
+        }
+        cout << threads << " 线程: 凸包 " << ms(t0, t1) << " ms (" << hull.size() << " 个顶点, 加速比 "
+             << hull1 / ms(t0, t1) << "), 最近点对 " << ms(t1, t2) << " ms (距离 " << sqrt(cp.distance2)
+             << ", 加速比 " << pair1 / ms(t1, t2) << ")" << endl;
+    }
+
+    // 小规模对照
+    const size_t SMALL = 3000;
+    vector<Vec2<double>> sample(cloud.begin(), cloud.begin() + SMALL);
+    ClosestPair brute = { 0, 0, numeric_limits<double>::infinity() };
+    for (size_t i = 0; i < SMALL; i++) {
+        for (size_t j = i + 1; j < SMALL; j++) {
+            double dx = sample[i].x - sample[j].x, dy = sample[i].y - sample[j].y;
+            if (dx * dx + dy * dy < brute.distance2) brute = { i, j, dx * dx + dy * dy };
+        }
+    }
+    ClosestPair fast = closestPair(sample.data(), SMALL, 4);
+    vector<Vec2<double>> copyOfSample = sample;
+    vector<Vec2<double>> serialHull = monotoneChain(copyOfSample);
+    vector<Vec2<double>> parallelHull = convexHull(sample.data(), SMALL, 4);
+    bool hullSame = serialHull.size() == parallelHull.size();
+    for (size_t i = 0; hullSame && i < serialHull.size(); i++) {
+        hullSame = serialHull[i].x == parallelHull[i].x && serialHull[i].y == parallelHull[i].y;
+    }
+    cout << "对照 (" << SMALL << " 个点): 最近点对 " << (fast.first == brute.first && fast.second == brute.second ? "一致" : "不一致")
+         << ", 凸包 " << (hullSame ? "一致" : "不一致") << endl;
+
+    // 近共线：c 在 0.5 附近按最小间隔 (ulp) 移动，a、b 取在直线 y = x 上
+    int wrong = 0, total = 0;
+    double ulp = nextafter(0.5, 1.0) - 0.5;
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j < 64; j++) {
+            double cx = 0.5 + i * ulp, cy = 0.5 + j * ulp;
+            double naive = (12 - cx) * (24 - cy) - (12 - cy) * (24 - cx);
+            int fastSign = naive > 0 ? 1 : (naive < 0 ? -1 : 0);
+            wrong += fastSign != orient2d(12, 12, 24, 24, cx, cy);
+            total++;
+        }
+    }
+    cout << "近共线点: 朴素浮点判定与精确结果不一致 " << wrong << " / " << total << " 次" << endl;
+}
+
+// 性能测试（main --bench）：200 万个点上的 k-d 树与暴力扫描（每个候选点算一次 distanceTo，含开方）对比
+// 单次查询看延迟，大量查询看吞吐量；批量查询与逐个查询、半径与矩形查询与暴力结果互相核对
+void benchKdTree() {
+    TRACE_SPAN("benchKdTree");
+    const size_t COUNT = 2000000;
+    const size_t QUERIES = 200000;
+    const size_t BRUTE_QUERIES = 100;
+    const size_t K = 8;
+    const int hw = max(1, (int)thread::hardware_concurrency());
+    cout << "[k-d 树] " << COUNT << " 个点, " << QUERIES << " 个查询, k = " << K << ", CPU 核心数 " << hw << endl;
+
+    mt19937 rng(11);
+    uniform_real_distribution<double> coord(0, 1e6);
+    vector<Vec2<double>> cloud(COUNT), queries(QUERIES);
+    for (auto& p : cloud) p = { coord(rng), coord(rng) };
+    for (auto& q : queries) q = { coord(rng), coord(rng) };
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    vector<int> threadCounts;
+    for (int t = 1; t < hw; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+    for (int threads : threadCounts) {
+        auto t0 = chrono::steady_clock::now();
+        KdTree<double> built(cloud.data(), COUNT, threads);
+        auto t1 = chrono::steady_clock::now();
+        cout << threads << " 线程建树: " << ms(t0, t1) << " ms" << endl;
+    }
+    KdTree<double> tree(cloud.data(), COUNT);
+
+    // 单次最近点延迟
+    vector<size_t> bruteAnswer(BRUTE_QUERIES);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < BRUTE_QUERIES; i++) {
+        double best = numeric_limits<double>::infinity();
+        for (size_t j = 0; j < COUNT; j++) {
+            double d = cloud[j].distanceTo(queries[i]);
+            if (d < best) {
+                best = d;
+                bruteAnswer[i] = j;
+            }
+        }
+    }
+    auto t1 = chrono::steady_clock::now();
+    size_t mismatches = 0;
+    for (size_t i = 0; i < BRUTE_QUERIES; i++) {
+        mismatches += tree.nearest(queries[i], 1)[0].index != bruteAnswer[i];
+    }
+    auto t2 = chrono::steady_clock::now();
+    cout << "最近点延迟: 暴力 " << ms(t0, t1) / BRUTE_QUERIES << " ms/次, k-d 树 "
+         << ms(t1, t2) * 1e3 / BRUTE_QUERIES << " us/次, 结果不一致 " << mismatches << " 次" << endl;
+
+    // k 近邻吞吐量：逐个查询与批量查询
+    vector<Neighbor> single(QUERIES * K), batched;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < QUERIES; i++) {
+        vector<Neighbor> nn = tree.nearest(queries[i], K);
+        copy(nn.begin(), nn.end(), single.begin() + i * K);
+    }
+    t1 = chrono::steady_clock::now();
+    cout << K << " 近邻吞吐量: 逐个查询 " << QUERIES / ms(t0, t1) << " 千次/s";
+    for (int threads : threadCounts) {
+        t0 = chrono::steady_clock::now();
+        tree.nearestBatch(queries.data(), QUERIES, K, batched, threads);
+        t1 = chrono::steady_clock::now();
+        cout << ", 批量 " << threads << " 线程 " << QUERIES / ms(t0, t1) << " 千次/s";
+    }
+    size_t batchDiff = 0;
+    for (size_t i = 0; i < single.size(); i++) {
+        batchDiff += single[i].distance2 != batched[i].distance2;
+    }
+    cout << ", 批量与逐个结果不同 " << batchDiff << " 处" << endl;
+
+    // 半径与矩形查询
+    const double R = 2000;
+    size_t found = 0, expected = 0;
+    vector<size_t> hits;
+    for (size_t i = 0; i < 20; i++) {
+        const Vec2<double>& q = queries[i];
+        hits.clear();
+        tree.radius(q, R, hits);
+        found += hits.size();
+        hits.clear();
+        tree.box(Vec2<double>{ q.x - R, q.y - R }, Vec2<double>{ q.x + R, q.y + R }, hits);
+        found += hits.size();
+        for (const auto& p : cloud) {
+            double dx = p.x - q.x, dy = p.y - q.y;
+            expected += dx * dx + dy * dy <= R * R;
+            expected += p.x >= q.x - R && p.x <= q.x + R && p.y >= q.y - R && p.y <= q.y + R;
+        }
+    }
+    cout << "半径/矩形查询 (20 次, 半径 " << R << "): 命中 " << found << " 个, 暴力 " << expected << " 个" << endl;
+}
+
+// 提交一帧的绘制命令，并在窗口底部显示本帧的命令数与状态切换次数
+void presentFrame(RenderQueue& queue, RenderBackend& backend) {
+    RenderStats stats = queue.flush(backend);
+    ostringstream oss;
+    oss << "绘制命令: " << stats.primitives << " 条, 状态切换 " << stats.stateChanges << " 次";
+    drawText(WINDOW_WIDTH - 360, WINDOW_HEIGHT - 40, oss.str(), LIGHTGREEN);
+}
+
+//==============================================================================
+// 动画：AnimationScene、FrameStats、runAnimation、runAnimationDemo 与 benchAnimation，与实验二共用
+//==============================================================================
+
+#include "../Shared/shape_animation.h"
+
+// populateScene：轮流放线段、圆、矩形、三角形，每个图形的中心即姿态位置
+void populateScene(AnimationScene& scene, int count, unsigned seed) {
+    const color_t PALETTE[] = { WHITE, RED, YELLOW, LIGHTGREEN, LIGHTCYAN };
+    const int COLORS = sizeof(PALETTE) / sizeof(PALETTE[0]);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> posX(40, WINDOW_WIDTH - 40), posY(80, WINDOW_HEIGHT - 40);
+    uniform_real_distribution<double> speed(-120, 120), spin(-90, 90), pulse(0.5, 2.0), phase(0, 2 * MY_PI);
+    for (int i = 0; i < count; i++) {
+        double x = posX(rng), y = posY(rng);
+        Shape* shape;
+        switch (i % 4) {
+        case 0: shape = new LineSegment(x - 12, y, x + 12, y); break;
+        case 1: shape = new Circle(x, y, 10); break;
+        case 2: shape = new Rect(x - 12, y - 8, 24, 16); break;
+        default: shape = new Triangle(x, y - 12, x - 10, y + 6, x + 10, y + 6); break;
+        }
+        Motion motion = { speed(rng), speed(rng), spin(rng), pulse(rng), phase(rng) };
+        scene.add(shape, x, y, motion, PALETTE[i % COLORS]);
+    }
+}
+
+ int main(int argc, char* argv[]) {
+     if (argc > 1 && string(argv[1]) == "--bench") {
+         benchAffine();
+         benchVertexPrecision();
+         benchRenderQueue();
+         benchAnimation();
+         benchGeometry();
+         benchKdTree();
+         TRACE_REPORT();
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--animate") {
+         int status = runAnimationDemo(argc, argv, "几何图形变换 - 学号: 24061824 姓名: 盛智超   ", BLACK);
+         TRACE_REPORT();
+         return status;
+     }
+
      initgraph(WINDOW_WIDTH, WINDOW_HEIGHT);
      setcaption("几何图形变换 - 学号: 24061824 姓名: 盛智超   ");
      setbkcolor(BLACK);
+     EgeBackend screen;
+     RenderQueue queue;
  
     vector<Shape*> shapes;
     shapes.push_back(new Point(100, 250, true));
@@ -474,79 +1673,103 @@ int Triangle::instanceCount = 0;
  
      cleardevice();
      drawTitle("1: 原始图形", 20);
-     int textY = 50;
-    ostringstream countInfo;
-    countInfo << "对象数量: 点=" << Point::getInstanceCount()
-              << " 线段=" << LineSegment::getInstanceCount()
-              << " 圆=" << Circle::getInstanceCount()
-              << " 矩形=" << Rect::getInstanceCount()
-              << " 三角形=" << Triangle::getInstanceCount();
-    drawText(20, textY, countInfo.str(), LIGHTGREEN);
-    textY += 25;
-     for (auto shape : shapes) {
-         drawText(20, textY, shape->getInfo(), LIGHTCYAN);
-         textY += 25;
-     }
-     for (auto shape : shapes) {
-         shape->draw(WHITE);
+     {
+         TRACE_SPAN("1: 原始图形");
+         int textY = 50;
+        ostringstream countInfo;
+        countInfo << "对象数量: 点=" << Point::getInstanceCount()
+                  << " 线段=" << LineSegment::getInstanceCount()
+                  << " 圆=" << Circle::getInstanceCount()
+                  << " 矩形=" << Rect::getInstanceCount()
+                  << " 三角形=" << Triangle::getInstanceCount();
+        drawText(20, textY, countInfo.str(), LIGHTGREEN);
+        textY += 25;
+         for (auto shape : shapes) {
+             drawText(20, textY, shape->getInfo(), LIGHTCYAN);
+             textY += 25;
+         }
+         for (auto shape : shapes) {
+             shape->draw(queue, WHITE);
+         }
+         drawText(800, 20, "白：原图", WHITE);
+         presentFrame(queue, screen);
      }
-     drawText(800, 20, "白：原图", WHITE);
      drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
      getch();
 
      cleardevice();
      drawTitle("2: 移动操作 (dx=50, dy=100)", 20);
-     for (auto shape : shapes) {
-         shape->draw(WHITE);
-     }
-     drawText(800, 20, "白：原图", WHITE);
-     for (auto shape : shapes) {
-         shape->move(50, 100);
-         shape->draw(RED);
+     {
+         TRACE_SPAN("2: 移动操作 (dx=50, dy=100)");
+         for (auto shape : shapes) {
+             shape->draw(queue, WHITE);
+         }
+         drawText(800, 20, "白：原图", WHITE);
+         queue.setLayer(1);
+         for (auto shape : shapes) {
+             shape->move(50, 100);
+             shape->draw(queue, RED);
+         }
+         drawText(800, 50, "红：改图", RED);
+         presentFrame(queue, screen);
      }
-     drawText(800, 50, "红：改图", RED);
      drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
      getch();
 
      cleardevice();
      drawTitle("3: 旋转操作 (45度)", 20);
-     for (auto shape : shapes) {
-         shape->draw(WHITE);
-     }
-     drawText(800, 20, "白：原图", WHITE);
-     for (auto shape : shapes) {
-         shape->rotate(45);
-         shape->draw(RED);
+     {
+         TRACE_SPAN("3: 旋转操作 (45度)");
+         for (auto shape : shapes) {
+             shape->draw(queue, WHITE);
+         }
+         drawText(800, 20, "白：原图", WHITE);
+         queue.setLayer(1);
+         for (auto shape : shapes) {
+             shape->rotate(45);
+             shape->draw(queue, RED);
+         }
+         drawText(800, 50, "红：改图", RED);
+         presentFrame(queue, screen);
      }
-     drawText(800, 50, "红：改图", RED);
      drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
      getch();
 
      cleardevice();
      drawTitle("4: 缩放操作 (1.5倍)", 20);
-     for (auto shape : shapes) {
-         shape->draw(WHITE);
-     }
-     drawText(800, 20, "白：原图", WHITE);
-     for (auto shape : shapes) {
-         shape->scale(1.5);
-         shape->draw(RED);
+     {
+         TRACE_SPAN("4: 缩放操作 (1.5倍)");
+         for (auto shape : shapes) {
+             shape->draw(queue, WHITE);
+         }
+         drawText(800, 20, "白：原图", WHITE);
+         queue.setLayer(1);
+         for (auto shape : shapes) {
+             shape->scale(1.5);
+             shape->draw(queue, RED);
+         }
+         drawText(800, 50, "红：改图", RED);
+         presentFrame(queue, screen);
      }
-     drawText(800, 50, "红：改图", RED);
      drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
      getch();
 
      cleardevice();
      drawTitle("5: 水平镜像操作", 20);
-     for (auto shape : shapes) {
-         shape->draw(WHITE);
-     }
-     drawText(800, 20, "白：原图", WHITE);
-     for (auto shape : shapes) {
-         shape->mirror(true);
-         shape->draw(RED);
+     {
+         TRACE_SPAN("5: 水平镜像操作");
+         for (auto shape : shapes) {
+             shape->draw(queue, WHITE);
+         }
+         drawText(800, 20, "白：原图", WHITE);
+         queue.setLayer(1);
+         for (auto shape : shapes) {
+             shape->mirror(true);
+             shape->draw(queue, RED);
+         }
+         drawText(800, 50, "红：改图", RED);
+         presentFrame(queue, screen);
      }
-     drawText(800, 50, "红：改图", RED);
      drawText(20, WINDOW_HEIGHT - 40, "按任意键退出程序...", YELLOW);
      getch();
 
@@ -555,6 +1778,7 @@ int Triangle::instanceCount = 0;
      }
  
      closegraph();
+     TRACE_REPORT();
  
      return 0;
  }
@@ -1,38 +1,79 @@
 /*
  * 实验三：模板和泛型编程
  * 任务1：堆排序函数模板
- * 任务2：可变参数模板函数
+ * 任务2：可变参数模板函数（折叠表达式 + 线程局部输出缓冲，可切换为异步后端）
+ * 任务3：外部归并排序（数据量大于内存时使用）
+ * 任务4：Top-K、部分排序与第 k 小选择
+ * 任务5：带 decreaseKey 的索引优先队列
+ * 任务6：按投影键排序（每个元素只计算一次键）与 argsort
+ *
+ * 运行 main --bench 执行性能测试
  */
 
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstdio>
+#include <stdexcept>
+#include <type_traits>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <random>
+#include <queue>
+#include <climits>
+#include <cstdint>
+#include <cmath>
+#include <charconv>
+#include <string_view>
+#include <sstream>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 using namespace std;
 
 // ==================== 任务1：堆排序函数模板 ====================
 
-// 辅助函数：维护堆性质（最大堆）
-template<typename T>
-void heapify(T* A, int n, int i) {
-    int largest = i;        // 初始化最大值为根节点
-    int left = 2 * i + 1;   // 左子节点
-    int right = 2 * i + 2;  // 右子节点
+// 辅助函数：维护堆性质（比较器版本）
+// comp(a, b) 为真表示 a 应位于 b 之上；采用迭代下沉，避免深层递归
+template<typename T, typename Compare>
+void heapify(T* A, int n, int i, Compare comp) {
+    while (true) {
+        int top = i;            // 初始化堆顶候选为根节点
+        int left = 2 * i + 1;   // 左子节点
+        int right = 2 * i + 2;  // 右子节点
 
-    // 如果左子节点存在且大于根节点
-    if (left < n && A[left] > A[largest]) {
-        largest = left;
-    }
+        if (left < n && comp(A[left], A[top])) {
+            top = left;
+        }
+        if (right < n && comp(A[right], A[top])) {
+            top = right;
+        }
 
-    // 如果右子节点存在且大于当前最大值
-    if (right < n && A[right] > A[largest]) {
-        largest = right;
+        // 堆顶候选就是根节点时结束，否则交换并继续向下调整
+        if (top == i) {
+            break;
+        }
+        swap(A[i], A[top]);
+        i = top;
     }
+}
 
-    // 如果最大值不是根节点，交换并继续调整
-    if (largest != i) {
-        swap(A[i], A[largest]);
-        heapify(A, n, largest);
-    }
+// 辅助函数：维护堆性质（最大堆）
+template<typename T>
+void heapify(T* A, int n, int i) {
+    heapify(A, n, i, greater<T>());
 }
 
 // 堆排序函数模板
@@ -62,24 +103,1637 @@ void printArray(T* A, int n) {
 
 // ==================== 任务2：可变参数模板函数 ====================
 
-// 递归终止函数：当参数包为空时调用
+// 输出缓冲：每个线程一个，格式化结果先写入缓冲区，再整块写出
+// 默认每行写出一次（与 cout << endl 行为一致）；PrintBatch 作用域内攒满 64KB 再写出
+class PrintSink {
+private:
+    static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    string buffer;
+    FILE* target = stdout;
+    int batchDepth = 0;
+
+public:
+    PrintSink() { buffer.reserve(2 * FLUSH_THRESHOLD); }
+    ~PrintSink() { flush(); }
+
+    static PrintSink& local() {
+        static thread_local PrintSink sink;
+        return sink;
+    }
+
+    // 按 cout 的默认格式把一个值追加到 out：整数为十进制，浮点数等价于 %g（精度 6），bool 为 1/0
+    // 其他类型回退到流格式化，保证与 cout 输出一致
+    template<typename T>
+    static void format(string& out, const T& x) {
+        if constexpr (is_same<T, bool>::value) {
+            out += x ? '1' : '0';
+        } else if constexpr (is_same<T, char>::value || is_same<T, signed char>::value ||
+                             is_same<T, unsigned char>::value) {
+            out += (char)x;
+        } else if constexpr (is_integral<T>::value) {
+            char tmp[24];
+            out.append(tmp, to_chars(tmp, tmp + sizeof(tmp), x).ptr);
+        } else if constexpr (is_floating_point<T>::value) {
+            char tmp[64];
+            out.append(tmp, to_chars(tmp, tmp + sizeof(tmp), x, chars_format::general, 6).ptr);
+        } else if constexpr (is_convertible<const T&, string_view>::value) {
+            out += string_view(x);
+        } else {
+            static thread_local ostringstream oss;
+            oss.str("");
+            oss << x;
+            out += oss.str();
+        }
+    }
+
+    template<typename T>
+    void append(const T& x) {
+        format(buffer, x);
+    }
+
+    // 行结束：非批量模式下立即写出
+    void endLine() {
+        buffer += '\n';
+        if (batchDepth == 0 || buffer.size() >= FLUSH_THRESHOLD) {
+            flush();
+        }
+    }
+
+    // 整块写出：先刷新 cout 保证先后顺序，再用一次 fwrite 写出全部缓冲
+    void flush() {
+        if (buffer.empty()) return;
+        cout.flush();
+        fwrite(buffer.data(), 1, buffer.size(), target);
+        fflush(target);
+        buffer.clear();
+    }
+
+    friend class PrintBatch;
+};
+
+// 批量输出作用域：作用域内的 print 不再逐行写出，可选地重定向到指定文件
+class PrintBatch {
+private:
+    FILE* previous;
+
+public:
+    explicit PrintBatch(FILE* target = nullptr) {
+        PrintSink& sink = PrintSink::local();
+        sink.flush();
+        previous = sink.target;
+        if (target) sink.target = target;
+        sink.batchDepth++;
+    }
+
+    ~PrintBatch() {
+        PrintSink& sink = PrintSink::local();
+        sink.flush();
+        sink.target = previous;
+        sink.batchDepth--;
+    }
+
+    PrintBatch(const PrintBatch&) = delete;
+    PrintBatch& operator=(const PrintBatch&) = delete;
+};
+
+// ---------- 异步模式 ----------
+
+// 缓冲区满时的处理策略：丢弃该条日志，或阻塞等待后台线程腾出空间
+enum class OverflowPolicy { Drop, Block };
+
+// 单生产者单消费者的无锁字节环形缓冲区，每个日志线程独占一个
+class LogRing {
+private:
+    vector<char> data;
+    size_t mask;
+    alignas(64) atomic<size_t> head{0};  // 消费者读位置
+    alignas(64) atomic<size_t> tail{0};  // 生产者写位置
+
+public:
+    atomic<bool> closed{false};  // 所属线程已退出
+    atomic<size_t> dropped{0};
+
+    explicit LogRing(size_t bytes) {
+        size_t capacity = 1024;
+        while (capacity < bytes) capacity <<= 1;
+        data.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    size_t capacity() const { return data.size(); }
+
+    // 生产者：空间足够时整条写入，否则返回 false
+    bool tryWrite(const char* src, size_t n) {
+        size_t t = tail.load(memory_order_relaxed);
+        size_t h = head.load(memory_order_acquire);
+        if (data.size() - (t - h) < n) {
+            return false;
+        }
+        size_t offset = t & mask;
+        size_t first = min(n, data.size() - offset);
+        memcpy(&data[offset], src, first);
+        memcpy(&data[0], src + first, n - first);
+        tail.store(t + n, memory_order_release);
+        return true;
+    }
+
+    // 消费者：把当前可读的全部字节追加到 out
+    size_t drain(vector<char>& out) {
+        size_t h = head.load(memory_order_relaxed);
+        size_t t = tail.load(memory_order_acquire);
+        size_t n = t - h;
+        if (n == 0) return 0;
+        size_t offset = h & mask;
+        size_t first = min(n, data.size() - offset);
+        out.insert(out.end(), &data[offset], &data[offset] + first);
+        out.insert(out.end(), &data[0], &data[0] + (n - first));
+        head.store(t, memory_order_release);
+        return n;
+    }
+
+    bool empty() const {
+        return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+    }
+};
+
+// 异步日志后端：print 在生产者线程只做二进制编码并写入本线程的环形缓冲区，
+// 由后台线程统一解码、格式化并批量写出；同一线程的日志保持先后顺序，行与行之间不会交错
+class AsyncLogger {
+private:
+    // 编码格式：[uint32 长度][(类型标记, 数据)...]
+    enum Tag : uint8_t { TagInt, TagUInt, TagDouble, TagChar, TagBool, TagString };
+
+    struct RingHandle {
+        shared_ptr<LogRing> ring;
+        unsigned generation = 0;
+        ~RingHandle() {
+            if (ring) ring->closed = true;
+        }
+    };
+
+    atomic<bool> running{false};
+    atomic<unsigned> generation{0};
+    FILE* target = stdout;
+    OverflowPolicy policy = OverflowPolicy::Block;
+    size_t ringBytes = 1 << 20;
+    chrono::milliseconds flushInterval{10};
+
+    mutex mtx;
+    condition_variable wakeup;
+    condition_variable flushed;
+    vector<shared_ptr<LogRing>> rings;
+    size_t retiredDropped = 0;  // 已移除的缓冲区累计的丢弃条数
+    atomic<bool> wakeRequested{false};
+    bool stopRequested = false;
+    unsigned long long flushRequested = 0;
+    unsigned long long flushDone = 0;
+    thread worker;
+
+    static AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    // 程序退出时若未调用 stop()，也要写出剩余日志并回收后台线程
+    ~AsyncLogger() {
+        shutdown();
+    }
+
+    void shutdown() {
+        if (!running) return;
+        running = false;
+        {
+            lock_guard<mutex> lock(mtx);
+            stopRequested = true;
+        }
+        wakeup.notify_one();
+        worker.join();
+        rings.clear();
+    }
+
+    template<typename T>
+    static void put(vector<char>& buf, const T& value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+
+    static void putString(vector<char>& buf, string_view sv) {
+        buf.push_back(TagString);
+        put(buf, (uint32_t)sv.size());
+        buf.insert(buf.end(), sv.begin(), sv.end());
+    }
+
+    // 按 PrintSink::format 的分类编码一个参数；不认识的类型先在生产者端格式化成字符串
+    template<typename T>
+    static void encode(vector<char>& buf, const T& x) {
+        if constexpr (is_same<T, bool>::value) {
+            buf.push_back(TagBool);
+            buf.push_back(x ? 1 : 0);
+        } else if constexpr (is_same<T, char>::value || is_same<T, signed char>::value ||
+                             is_same<T, unsigned char>::value) {
+            buf.push_back(TagChar);
+            buf.push_back((char)x);
+        } else if constexpr (is_integral<T>::value && is_signed<T>::value) {
+            buf.push_back(TagInt);
+            put(buf, (long long)x);
+        } else if constexpr (is_integral<T>::value) {
+            buf.push_back(TagUInt);
+            put(buf, (unsigned long long)x);
+        } else if constexpr (is_same<T, float>::value || is_same<T, double>::value) {
+            buf.push_back(TagDouble);
+            put(buf, (double)x);
+        } else if constexpr (is_convertible<const T&, string_view>::value) {
+            putString(buf, string_view(x));
+        } else {
+            string text;
+            PrintSink::format(text, x);
+            putString(buf, text);
+        }
+    }
+
+    template<typename T>
+    static T get(const char*& p) {
+        T value;
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    // 解码一段连续的记录，格式化为文本行追加到 out
+    static void decode(const vector<char>& in, string& out) {
+        const char* p = in.data();
+        const char* end = p + in.size();
+        while (p < end) {
+            uint32_t size = get<uint32_t>(p);
+            const char* recordEnd = p + size;
+            bool first = true;
+            while (p < recordEnd) {
+                if (!first) out += ' ';
+                first = false;
+                switch ((Tag)*p++) {
+                case TagInt: PrintSink::format(out, get<long long>(p)); break;
+                case TagUInt: PrintSink::format(out, get<unsigned long long>(p)); break;
+                case TagDouble: PrintSink::format(out, get<double>(p)); break;
+                case TagChar: out += *p++; break;
+                case TagBool: out += *p++ ? '1' : '0'; break;
+                case TagString: {
+                    uint32_t len = get<uint32_t>(p);
+                    out.append(p, len);
+                    p += len;
+                    break;
+                }
+                }
+            }
+            out += '\n';
+        }
+    }
+
+    LogRing& localRing() {
+        static thread_local RingHandle handle;
+        unsigned gen = generation.load(memory_order_acquire);
+        if (!handle.ring || handle.generation != gen) {
+            if (handle.ring) handle.ring->closed = true;
+            handle.ring = make_shared<LogRing>(ringBytes);
+            handle.generation = gen;
+            lock_guard<mutex> lock(mtx);
+            rings.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    void requestWake() {
+        wakeRequested.store(true, memory_order_relaxed);
+        wakeup.notify_one();
+    }
+
+    void writeOut(string& text) {
+        if (text.empty()) return;
+        fwrite(text.data(), 1, text.size(), target);
+        fflush(target);
+        text.clear();
+    }
+
+    // 后台线程：至多每 flushInterval 醒来一次，取出所有缓冲区的数据并批量写出
+    void run() {
+        vector<char> raw;
+        string text;
+        raw.reserve(ringBytes);
+        text.reserve(2 * ringBytes);
+        while (true) {
+            unique_lock<mutex> lock(mtx);
+            wakeup.wait_for(lock, flushInterval, [this]() {
+                return stopRequested || flushRequested > flushDone || wakeRequested.load(memory_order_relaxed);
+            });
+            wakeRequested.store(false, memory_order_relaxed);
+            bool stopping = stopRequested;
+            unsigned long long request = flushRequested;
+            vector<shared_ptr<LogRing>> snapshot(rings);
+            lock.unlock();
+
+            for (auto& ring : snapshot) {
+                raw.clear();
+                ring->drain(raw);
+                decode(raw, text);
+                if (text.size() >= 64 * 1024) writeOut(text);
+            }
+            writeOut(text);
+
+            lock.lock();
+            rings.erase(remove_if(rings.begin(), rings.end(), [this](const shared_ptr<LogRing>& r) {
+                if (!r->closed || !r->empty()) return false;
+                retiredDropped += r->dropped;
+                return true;
+            }), rings.end());
+            flushDone = request;
+            flushed.notify_all();
+            if (stopping) break;
+        }
+    }
+
+public:
+    // 启动异步模式：之后所有线程的 print 都经由后台线程写到 target
+    static void start(FILE* target = stdout, OverflowPolicy policy = OverflowPolicy::Block,
+                      size_t ringBytes = 1 << 20, chrono::milliseconds flushInterval = chrono::milliseconds(10)) {
+        AsyncLogger& logger = instance();
+        if (logger.running) return;
+        PrintSink::local().flush();
+        cout.flush();
+        logger.target = target;
+        logger.policy = policy;
+        logger.ringBytes = ringBytes;
+        logger.flushInterval = flushInterval;
+        logger.stopRequested = false;
+        logger.retiredDropped = 0;
+        logger.generation++;
+        logger.worker = thread(&AsyncLogger::run, &logger);
+        logger.running = true;
+    }
+
+    // 停止异步模式并写出剩余日志；调用前应确保其他线程已不再 print
+    static void stop() {
+        instance().shutdown();
+    }
+
+    static bool enabled() {
+        return instance().running.load(memory_order_relaxed);
+    }
+
+    // 等待调用之前写入的日志全部落盘
+    static void flush() {
+        AsyncLogger& logger = instance();
+        if (!logger.running) return;
+        unique_lock<mutex> lock(logger.mtx);
+        unsigned long long ticket = ++logger.flushRequested;
+        logger.wakeup.notify_one();
+        logger.flushed.wait(lock, [&logger, ticket]() { return logger.flushDone >= ticket; });
+    }
+
+    // 本次 start() 以来 Drop 策略下因缓冲区满或单条过长而丢弃的日志条数，含已退出线程的缓冲区
+    static size_t droppedCount() {
+        AsyncLogger& logger = instance();
+        lock_guard<mutex> lock(logger.mtx);
+        size_t total = logger.retiredDropped;
+        for (auto& ring : logger.rings) total += ring->dropped;
+        return total;
+    }
+
+    template<typename... Args>
+    static void log(const Args&... args) {
+        AsyncLogger& logger = instance();
+        static thread_local vector<char> record;
+        record.assign(sizeof(uint32_t), 0);
+        (encode(record, args), ...);
+        uint32_t size = (uint32_t)(record.size() - sizeof(uint32_t));
+        memcpy(record.data(), &size, sizeof(size));
+
+        LogRing& ring = logger.localRing();
+        if (record.size() > ring.capacity()) {
+            // 单条比缓冲区还大：Drop 策略计为丢弃；Block 策略等本线程之前的日志落盘后在当前线程直接写出，先后顺序不变
+            if (logger.policy == OverflowPolicy::Drop) {
+                ring.dropped++;
+                return;
+            }
+            flush();
+            string text;
+            decode(record, text);
+            fwrite(text.data(), 1, text.size(), logger.target);
+            fflush(logger.target);
+            return;
+        }
+        if (ring.tryWrite(record.data(), record.size())) return;
+        logger.requestWake();
+        if (logger.policy == OverflowPolicy::Drop) {
+            ring.dropped++;
+            return;
+        }
+        // Block 策略：睡在 flushed 上，后台线程每取完一轮数据唤醒一次，不空转占用 CPU
+        unique_lock<mutex> lock(logger.mtx);
+        while (!ring.tryWrite(record.data(), record.size())) {
+            logger.requestWake();
+            logger.flushed.wait_for(lock, logger.flushInterval);
+        }
+    }
+};
+
+// 无参数：只输出换行
 void print() {
-    cout << endl;
+    if (AsyncLogger::enabled()) {
+        AsyncLogger::log();
+        return;
+    }
+    PrintSink::local().endLine();
 }
 
-// 参数包展开函数：递归展开并输出参数
+// 参数包展开：折叠表达式依次格式化到缓冲区，参数之间用空格分隔
 template<typename T, typename... Args>
-void print(T first, Args... args) {
-    cout << first;
+void print(const T& first, const Args&... args) {
+    if (AsyncLogger::enabled()) {
+        AsyncLogger::log(first, args...);
+        return;
+    }
+    PrintSink& sink = PrintSink::local();
+    sink.append(first);
+    ((sink.append(' '), sink.append(args)), ...);
+    sink.endLine();
+}
+
+// ==================== 任务3：外部归并排序 ====================
+
+// 外部排序的统计信息
+struct ExternalSortStats {
+    size_t records = 0;       // 记录总数
+    size_t runs = 0;          // 初始顺串数
+    int mergePasses = 0;      // 归并趟数
+    double runSeconds = 0;    // 顺串生成阶段耗时（秒）
+    double mergeSeconds = 0;  // 归并阶段耗时（秒）
+
+    // 整体吞吐量（MB/s），按输入数据量计算
+    double throughputMBps(size_t recordSize) const {
+        double seconds = runSeconds + mergeSeconds;
+        if (seconds <= 0) return 0;
+        return records * (double)recordSize / (1024.0 * 1024.0) / seconds;
+    }
+};
+
+const size_t IO_ALIGN = 4096;  // I/O 缓冲区对齐（页大小）
+
+// 按页对齐的 I/O 缓冲区
+class AlignedBuffer {
+private:
+    char* ptr;
+    size_t capacity;
+
+public:
+    explicit AlignedBuffer(size_t bytes)
+        : capacity((bytes + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN) {
+        ptr = static_cast<char*>(::operator new(capacity, align_val_t(IO_ALIGN)));
+    }
+    ~AlignedBuffer() { ::operator delete(ptr, align_val_t(IO_ALIGN)); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    char* data() const { return ptr; }
+};
+
+// 顺串读取器：双缓冲，消费当前块的同时在后台线程预读下一块
+template<typename T>
+class RunReader {
+private:
+    FILE* fp;
+    size_t blockRecords;
+    AlignedBuffer buffers[2];
+    int current = 0;
+    size_t count = 0;  // 当前块中的记录数
+    size_t pos = 0;    // 当前块中的读取位置
+    future<size_t> pending;
+
+    void prefetch() {
+        FILE* f = fp;
+        char* dst = buffers[1 - current].data();
+        size_t bytes = blockRecords * sizeof(T);
+        pending = async(launch::async, [f, dst, bytes]() { return fread(dst, 1, bytes, f); });
+    }
+
+    void refill() {
+        count = 0;
+        pos = 0;
+        if (!pending.valid()) return;
+        size_t got = pending.get();
+        current = 1 - current;
+        count = got / sizeof(T);
+        // 读满一整块说明文件可能还有数据，继续预读
+        if (got == blockRecords * sizeof(T)) {
+            prefetch();
+        }
+    }
+
+public:
+    RunReader(const string& path, size_t blockBytes)
+        : blockRecords(max<size_t>(1, blockBytes / sizeof(T))),
+          buffers{ AlignedBuffer(blockRecords * sizeof(T)), AlignedBuffer(blockRecords * sizeof(T)) } {
+        fp = fopen(path.c_str(), "rb");
+        if (!fp) throw runtime_error("无法打开顺串文件: " + path);
+        setvbuf(fp, nullptr, _IONBF, 0);  // 自己管理缓冲，关闭 stdio 缓冲
+        prefetch();
+        refill();
+    }
+
+    ~RunReader() {
+        if (pending.valid()) pending.wait();
+        fclose(fp);
+    }
+
+    bool valid() const { return pos < count; }
+    const T& head() const { return reinterpret_cast<const T*>(buffers[current].data())[pos]; }
+
+    void advance() {
+        if (++pos == count) refill();
+    }
+};
+
+// 顺串写入器：双缓冲，填充当前块的同时在后台线程写出上一块
+template<typename T>
+class RunWriter {
+private:
+    FILE* fp;
+    size_t blockRecords;
+    AlignedBuffer buffers[2];
+    int current = 0;
+    size_t count = 0;
+    future<size_t> pending;
+    size_t pendingBytes = 0;  // 后台正在写出的字节数
+
+    // 等待上一块写完，返回是否完整写出
+    bool waitPending() {
+        return !pending.valid() || pending.get() == pendingBytes;
+    }
+
+    void flush() {
+        if (!waitPending()) {
+            throw runtime_error("写入输出文件失败");
+        }
+        if (count == 0) return;
+        FILE* f = fp;
+        char* src = buffers[current].data();
+        size_t bytes = count * sizeof(T);
+        pendingBytes = bytes;
+        pending = async(launch::async, [f, src, bytes]() { return fwrite(src, 1, bytes, f); });
+        current = 1 - current;
+        count = 0;
+    }
+
+public:
+    RunWriter(const string& path, size_t blockBytes)
+        : blockRecords(max<size_t>(1, blockBytes / sizeof(T))),
+          buffers{ AlignedBuffer(blockRecords * sizeof(T)), AlignedBuffer(blockRecords * sizeof(T)) } {
+        fp = fopen(path.c_str(), "wb");
+        if (!fp) throw runtime_error("无法创建输出文件: " + path);
+        setvbuf(fp, nullptr, _IONBF, 0);
+    }
+
+    // 析构时不抛异常：正常流程应显式调用 close() 以得知写入是否成功，
+    // 只有出错提前退出时才由析构关闭文件，此时的写入错误被忽略
+    ~RunWriter() noexcept {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void push(const T& x) {
+        reinterpret_cast<T*>(buffers[current].data())[count++] = x;
+        if (count == blockRecords) flush();
+    }
+
+    // 写出剩余数据并关闭文件；写入失败时抛出异常，文件同样会关闭
+    void close() {
+        if (!fp) return;
+        bool ok = waitPending();
+        size_t bytes = count * sizeof(T);
+        if (ok && bytes > 0) ok = fwrite(buffers[current].data(), 1, bytes, fp) == bytes;
+        count = 0;
+        ok = fclose(fp) == 0 && ok;
+        fp = nullptr;
+        if (!ok) throw runtime_error("写入输出文件失败");
+    }
+};
+
+// k 路归并：以顺串编号构成小顶堆，复用 heapify 维护堆性质
+template<typename T>
+void mergeRuns(const vector<string>& inputs, const string& outPath, size_t blockBytes) {
+    vector<unique_ptr<RunReader<T>>> readers;
+    vector<int> heap;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        readers.emplace_back(new RunReader<T>(inputs[i], blockBytes));
+        if (readers.back()->valid()) heap.push_back((int)i);
+    }
+
+    // 队首记录更小的顺串位于堆顶（只依赖 operator>）
+    auto comp = [&readers](int a, int b) { return readers[b]->head() > readers[a]->head(); };
+    int n = (int)heap.size();
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        heapify(heap.data(), n, i, comp);
+    }
+
+    RunWriter<T> writer(outPath, blockBytes);
+    while (n > 0) {
+        RunReader<T>& top = *readers[heap[0]];
+        writer.push(top.head());
+        top.advance();
+        if (!top.valid()) {
+            heap[0] = heap[--n];  // 顺串耗尽，移出堆
+        }
+        heapify(heap.data(), n, 0, comp);
+    }
+    writer.close();
+}
+
+// 把 data 中已各自有序的若干段 [bounds[s], bounds[s+1]) 归并后写成一个顺串
+template<typename T>
+void writeMergedRun(const T* data, const vector<size_t>& bounds, const string& path, size_t blockBytes) {
+    vector<size_t> pos(bounds.begin(), bounds.end() - 1);  // 各段的当前位置
+    vector<int> heap;
+    for (size_t s = 0; s + 1 < bounds.size(); s++) {
+        if (bounds[s] < bounds[s + 1]) heap.push_back((int)s);
+    }
+
+    auto comp = [&data, &pos](int a, int b) { return data[pos[b]] > data[pos[a]]; };
+    int n = (int)heap.size();
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        heapify(heap.data(), n, i, comp);
+    }
+
+    RunWriter<T> writer(path, blockBytes);
+    while (n > 0) {
+        int s = heap[0];
+        writer.push(data[pos[s]]);
+        if (++pos[s] == bounds[s + 1]) {
+            heap[0] = heap[--n];  // 该段耗尽，移出堆
+        }
+        heapify(heap.data(), n, 0, comp);
+    }
+    writer.close();
+}
+
+// 临时文件名前缀：目录 + 进程号 + 本进程内的排序序号，同一目录下并发的多个排序互不覆盖
+inline string tempRunPrefix(const string& tmpDir) {
+    static atomic<unsigned> sortId{0};
+#ifdef _WIN32
+    int pid = _getpid();
+#else
+    int pid = (int)getpid();
+#endif
+    return tmpDir + "/extsort_" + to_string(pid) + "_" + to_string(sortId++) + "_";
+}
+
+// 临时文件集合：析构时删除登记过的全部文件，排序中途抛出异常也不会留下顺串
+class TempFileSet {
+private:
+    vector<string> names;
+
+public:
+    TempFileSet() = default;
+    TempFileSet(const TempFileSet&) = delete;
+    TempFileSet& operator=(const TempFileSet&) = delete;
+
+    ~TempFileSet() {
+        for (const auto& name : names) remove(name.c_str());
+    }
+
+    string add(const string& name) {
+        names.push_back(name);
+        return name;
+    }
+};
+
+// 外部排序：按内存预算读入一块，分段并行排序后在内存中归并写成一个顺串，再多趟 k 路归并
+// T 须为可平凡复制的定长记录，并支持 operator>
+template<typename T>
+ExternalSortStats externalSort(const string& inPath, const string& outPath, size_t memoryBytes,
+                               int threads = 0, const string& tmpDir = ".", int fanIn = 64) {
+    static_assert(is_trivially_copyable<T>::value, "externalSort 要求定长的可平凡复制记录");
+    if (threads <= 0) threads = max(1, (int)thread::hardware_concurrency());
+    fanIn = max(fanIn, 2);
+
+    ExternalSortStats stats;
+    auto start = chrono::steady_clock::now();
+
+    // 阶段1：生成顺串
+    FILE* in = fopen(inPath.c_str(), "rb");
+    if (!in) throw runtime_error("无法打开输入文件: " + inPath);
+    setvbuf(in, nullptr, _IONBF, 0);
+
+    // 预算中留出写顺串用的两个缓冲块，其余用来装一块输入
+    size_t writeBlock = max<size_t>(IO_ALIGN, min<size_t>(1024 * 1024, memoryBytes / 16 / IO_ALIGN * IO_ALIGN));
+    size_t chunkBytes = memoryBytes > 2 * writeBlock ? memoryBytes - 2 * writeBlock : memoryBytes / 2;
+    size_t chunkRecords = max<size_t>(threads, chunkBytes / sizeof(T));
+    vector<T> chunk(chunkRecords);
+    vector<string> runs;
+    int tmpId = 0;
+    TempFileSet tmpFiles;
+    string prefix = tempRunPrefix(tmpDir);
+    auto tmpName = [&]() { return tmpFiles.add(prefix + to_string(tmpId++) + ".bin"); };
+
+    while (true) {
+        size_t got = fread(chunk.data(), sizeof(T), chunkRecords, in);
+        if (got == 0) break;
+        stats.records += got;
+
+        // 切分为 threads 段并行排序，再归并成一个顺串：顺串数只取决于内存预算，与核数无关
+        size_t slice = (got + threads - 1) / threads;
+        vector<size_t> bounds;
+        vector<thread> workers;
+        for (size_t begin = 0; begin < got; begin += slice) {
+            size_t end = min(got, begin + slice);
+            bounds.push_back(begin);
+            workers.emplace_back([&chunk, begin, end]() {
+                std::sort(chunk.begin() + begin, chunk.begin() + end,
+                          [](const T& a, const T& b) { return b > a; });
+            });
+        }
+        bounds.push_back(got);
+        for (auto& w : workers) w.join();
+
+        runs.push_back(tmpName());
+        try {
+            writeMergedRun(chunk.data(), bounds, runs.back(), writeBlock);
+        } catch (...) {
+            fclose(in);
+            throw runtime_error("写入临时顺串失败，请检查临时目录: " + tmpDir);
+        }
+        if (got < chunkRecords) break;
+    }
+    fclose(in);
+    vector<T>().swap(chunk);  // 归并阶段的缓冲区另按 memoryBytes 分配，先释放顺串缓冲，峰值内存才不会翻倍
+    stats.runs = runs.size();
+    auto runEnd = chrono::steady_clock::now();
+    stats.runSeconds = chrono::duration<double>(runEnd - start).count();
+
+    // 阶段2：多趟归并，每趟最多合并 fanIn 个顺串；每个输入顺串和输出各占两个缓冲块
+    // 块大小取 64 KiB ~ 8 MiB，但预算摊不到 64 KiB 时按预算缩小（至少一页），缓冲总量不超过 memoryBytes
+    size_t share = memoryBytes / (2 * (size_t)(fanIn + 1)) / IO_ALIGN * IO_ALIGN;
+    size_t floorBytes = max<size_t>(IO_ALIGN, min<size_t>(64 * 1024, share));
+    size_t blockBytes = max<size_t>(floorBytes, min<size_t>(8 * 1024 * 1024, share));
+
+    while (runs.size() > (size_t)fanIn) {
+        vector<string> next;
+        for (size_t i = 0; i < runs.size(); i += fanIn) {
+            vector<string> group(runs.begin() + i, runs.begin() + min(runs.size(), i + fanIn));
+            if (group.size() == 1) {
+                next.push_back(group[0]);
+                continue;
+            }
+            next.push_back(tmpName());
+            mergeRuns<T>(group, next.back(), blockBytes);
+            for (const auto& name : group) remove(name.c_str());
+        }
+        runs.swap(next);
+        stats.mergePasses++;
+    }
+
+    mergeRuns<T>(runs, outPath, blockBytes);
+    stats.mergePasses++;
+
+    stats.mergeSeconds = chrono::duration<double>(chrono::steady_clock::now() - runEnd).count();
+    return stats;
+}
+
+// ==================== 任务4：Top-K 与部分排序 ====================
+
+// 辅助函数：上浮调整（与 heapify 的比较器约定一致）
+template<typename T, typename Compare>
+void siftUp(T* A, int i, Compare comp) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!comp(A[i], A[parent])) {
+            break;
+        }
+        swap(A[i], A[parent]);
+        i = parent;
+    }
+}
+
+// 部分排序：结束后 A[0..k) 为按 comp 排序的前 k 小元素，其余元素顺序不定
+// 用前 k 个元素维护一个大顶堆，复杂度 O(n log k)
+template<typename T, typename Compare>
+void partialSort(T* A, int n, int k, Compare comp) {
+    k = min(k, n);
+    if (k <= 0) return;
+    auto above = [&comp](const T& a, const T& b) { return comp(b, a); };
+
+    for (int i = k / 2 - 1; i >= 0; i--) {
+        heapify(A, k, i, above);
+    }
+    for (int i = k; i < n; i++) {
+        if (comp(A[i], A[0])) {
+            swap(A[0], A[i]);
+            heapify(A, k, 0, above);
+        }
+    }
+    for (int i = k - 1; i > 0; i--) {
+        swap(A[0], A[i]);
+        heapify(A, i, 0, above);
+    }
+}
+
+template<typename T>
+void partialSort(T* A, int n, int k) {
+    partialSort(A, n, k, less<T>());
+}
+
+// 第 k 小元素选择：结束后 A[k] 为排序后该位置的元素，
+// A[0..k) 均不大于它，A[k+1..n) 均不小于它
+// 在较短的一侧维护堆，复杂度 O(n log min(k, n - k))
+template<typename T, typename Compare>
+void nthElement(T* A, int n, int k, Compare comp) {
+    if (k < 0 || k >= n) return;
+
+    if (k < n / 2) {
+        // 前 k+1 个元素构成大顶堆，堆顶即第 k 小
+        int m = k + 1;
+        auto above = [&comp](const T& a, const T& b) { return comp(b, a); };
+        for (int i = m / 2 - 1; i >= 0; i--) {
+            heapify(A, m, i, above);
+        }
+        for (int i = m; i < n; i++) {
+            if (comp(A[i], A[0])) {
+                swap(A[0], A[i]);
+                heapify(A, m, 0, above);
+            }
+        }
+        swap(A[0], A[k]);
+    } else {
+        // 后 n-k 个元素构成小顶堆，堆顶恰好位于 A[k]
+        T* B = A + k;
+        int m = n - k;
+        for (int i = m / 2 - 1; i >= 0; i--) {
+            heapify(B, m, i, comp);
+        }
+        for (int i = 0; i < k; i++) {
+            if (comp(B[0], A[i])) {
+                swap(B[0], A[i]);
+                heapify(B, m, 0, comp);
+            }
+        }
+    }
+}
+
+template<typename T>
+void nthElement(T* A, int n, int k) {
+    nthElement(A, n, k, less<T>());
+}
+
+// 流式 Top-K 累加器：保留按 Compare 排序最大的 k 个元素
+// 内部为容量固定的小顶堆，堆顶即当前门槛值
+template<typename T, typename Compare = less<T>>
+class TopK {
+private:
+    vector<T> heap;
+    int k;
+    Compare comp;
+
+public:
+    explicit TopK(int k, Compare comp = Compare()) : k(max(k, 0)), comp(comp) {
+        heap.reserve(this->k);
+    }
+
+    int size() const { return (int)heap.size(); }
+    bool full() const { return (int)heap.size() == k; }
+
+    // 当前门槛值（第 k 大的元素），仅在 full() 时有意义
+    const T& threshold() const { return heap[0]; }
+
+    // 单个元素入流，返回是否被保留
+    bool push(const T& x) {
+        if (k == 0) {
+            return false;
+        }
+        if (!full()) {
+            heap.push_back(x);
+            siftUp(heap.data(), (int)heap.size() - 1, comp);
+            return true;
+        }
+        if (!comp(heap[0], x)) {
+            return false;
+        }
+        heap[0] = x;
+        heapify(heap.data(), k, 0, comp);
+        return true;
+    }
+
+    // 批量入流：堆满后门槛值缓存在局部变量中，
+    // 不超过门槛的元素只做一次比较，不访问堆
+    void push(const T* data, size_t n) {
+        if (k == 0) return;
+        size_t i = 0;
+        while (i < n && !full()) {
+            push(data[i++]);
+        }
+        if (i == n) return;
+
+        T* h = heap.data();
+        T limit = h[0];
+        for (; i < n; i++) {
+            if (comp(limit, data[i])) {
+                h[0] = data[i];
+                heapify(h, k, 0, comp);
+                limit = h[0];
+            }
+        }
+    }
+
+    void push(const vector<T>& data) {
+        push(data.data(), data.size());
+    }
+
+    // 按从大到小的顺序返回保留的元素
+    vector<T> sorted() const {
+        vector<T> result(heap);
+        int n = (int)result.size();
+        for (int i = n - 1; i > 0; i--) {
+            swap(result[0], result[i]);
+            heapify(result.data(), i, 0, comp);
+        }
+        return result;
+    }
+
+    void clear() { heap.clear(); }
+};
+
+// ==================== 任务5：索引优先队列 ====================
+
+// 索引 d 叉堆：元素以句柄（0 ~ capacity-1 的整数）标识，
+// pos 记录每个句柄在堆数组中的位置，从而支持按句柄修改键和删除
+// Compare 与 heapify 的约定一致：comp(a, b) 为真表示 a 应位于 b 之上，默认小顶堆
+template<typename Key, int D = 4, typename Compare = less<Key>>
+class IndexedPriorityQueue {
+    static_assert(D >= 2, "IndexedPriorityQueue 的分叉数至少为 2");
+
+private:
+    vector<int> heap;  // 堆数组，存放句柄
+    vector<int> pos;   // 句柄 -> 堆中位置，-1 表示不在队列中
+    vector<Key> keys;  // 句柄 -> 键
+    Compare comp;
+
+    // 上浮：用“空穴”法移动，只在最终位置写入一次
+    void siftUp(int i) {
+        int h = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (!comp(keys[h], keys[heap[parent]])) {
+                break;
+            }
+            heap[i] = heap[parent];
+            pos[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = h;
+        pos[h] = i;
+    }
+
+    // 下沉：在至多 D 个子节点中选出最靠前的一个
+    void siftDown(int i) {
+        int n = (int)heap.size();
+        int h = heap[i];
+        while (true) {
+            int first = D * i + 1;
+            if (first >= n) {
+                break;
+            }
+            int last = min(first + D, n);
+            int best = first;
+            for (int c = first + 1; c < last; c++) {
+                if (comp(keys[heap[c]], keys[heap[best]])) {
+                    best = c;
+                }
+            }
+            if (!comp(keys[heap[best]], keys[h])) {
+                break;
+            }
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = h;
+        pos[h] = i;
+    }
+
+    void checkHandle(int h) const {
+        if (!contains(h)) {
+            throw out_of_range("IndexedPriorityQueue: 句柄不在队列中: " + to_string(h));
+        }
+    }
+
+public:
+    explicit IndexedPriorityQueue(int capacity = 0, Compare comp = Compare())
+        : pos(capacity, -1), keys(capacity), comp(comp) {
+        heap.reserve(capacity);
+    }
+
+    bool empty() const { return heap.empty(); }
+    int size() const { return (int)heap.size(); }
+    int capacity() const { return (int)pos.size(); }
+
+    bool contains(int h) const {
+        return h >= 0 && h < (int)pos.size() && pos[h] >= 0;
+    }
+
+    const Key& key(int h) const {
+        checkHandle(h);
+        return keys[h];
+    }
+
+    // 堆顶句柄及其键
+    int top() const { return heap[0]; }
+    const Key& topKey() const { return keys[heap[0]]; }
+
+    // 插入句柄 h；句柄超出容量时自动扩容
+    void push(int h, const Key& k) {
+        if (h < 0) {
+            throw out_of_range("IndexedPriorityQueue: 句柄不能为负数");
+        }
+        if (h >= (int)pos.size()) {
+            pos.resize(h + 1, -1);
+            keys.resize(h + 1);
+        }
+        if (pos[h] >= 0) {
+            throw invalid_argument("IndexedPriorityQueue: 句柄已在队列中: " + to_string(h));
+        }
+        keys[h] = k;
+        heap.push_back(h);
+        siftUp((int)heap.size() - 1);
+    }
+
+    // 弹出堆顶，返回其句柄
+    int pop() {
+        int h = heap[0];
+        int last = heap.back();
+        heap.pop_back();
+        pos[h] = -1;
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            siftDown(0);
+        }
+        return h;
+    }
+
+    // 新键更靠近堆顶（小顶堆中即变小）
+    void decreaseKey(int h, const Key& k) {
+        checkHandle(h);
+        keys[h] = k;
+        siftUp(pos[h]);
+    }
+
+    // 新键更远离堆顶（小顶堆中即变大）
+    void increaseKey(int h, const Key& k) {
+        checkHandle(h);
+        keys[h] = k;
+        siftDown(pos[h]);
+    }
+
+    // 不确定方向时使用：句柄不在队列中则插入
+    void update(int h, const Key& k) {
+        if (!contains(h)) {
+            push(h, k);
+        } else if (comp(k, keys[h])) {
+            decreaseKey(h, k);
+        } else {
+            increaseKey(h, k);
+        }
+    }
+
+    // 按句柄删除任意元素
+    void erase(int h) {
+        checkHandle(h);
+        int i = pos[h];
+        int last = heap.back();
+        heap.pop_back();
+        pos[h] = -1;
+        if (i < (int)heap.size()) {
+            heap[i] = last;
+            pos[last] = i;
+            siftUp(i);
+            siftDown(pos[last]);
+        }
+    }
+
+    void clear() {
+        for (int h : heap) pos[h] = -1;
+        heap.clear();
+    }
+};
+
+// ==================== 任务6：按键排序（键缓存） ====================
+
+// 恒等投影：argsort 不指定投影时按元素本身排序
+struct Identity {
+    template<typename T>
+    T&& operator()(T&& x) const { return forward<T>(x); }
+};
+
+// 辅助函数：对每个元素只计算一次投影，得到按键排好序的 (键, 下标) 数组
+// 下标作为次关键字，保证排序稳定
+template<typename Index, typename RandomIt, typename Projection, typename Compare>
+auto sortedKeyIndex(RandomIt first, RandomIt last, Projection& proj, Compare& comp) {
+    using Key = decay_t<invoke_result_t<Projection&, decltype(*first)>>;
+    Index n = (Index)(last - first);
+    vector<pair<Key, Index>> order;
+    order.reserve(n);
+    for (Index i = 0; i < n; i++) {
+        order.emplace_back(invoke(proj, first[i]), i);
+    }
+    std::sort(order.begin(), order.end(), [&comp](const pair<Key, Index>& a, const pair<Key, Index>& b) {
+        if (comp(a.first, b.first)) return true;
+        if (comp(b.first, a.first)) return false;
+        return a.second < b.second;
+    });
+    return order;
+}
+
+// 辅助函数：沿置换环原地移动元素，位置 i 接收原下标 order[i].second 处的元素
+template<typename RandomIt, typename Key, typename Index>
+void applyPermutation(RandomIt first, vector<pair<Key, Index>>& order) {
+    Index n = (Index)order.size();
+    for (Index i = 0; i < n; i++) {
+        if (order[i].second == i) continue;
+        auto tmp = move(first[i]);
+        Index j = i;
+        while (true) {
+            Index src = order[j].second;
+            order[j].second = j;  // 标记该位置已就位
+            if (src == i) {
+                first[j] = move(tmp);
+                break;
+            }
+            first[j] = move(first[src]);
+            j = src;
+        }
+    }
+}
+
+// 按投影键稳定排序 [first, last)：投影对每个元素只求值一次
+// proj 可以是函数对象或成员指针（如 &Shape::getArea），comp 比较键
+template<typename RandomIt, typename Projection, typename Compare = less<>>
+void sortByKey(RandomIt first, RandomIt last, Projection proj, Compare comp = Compare()) {
+    size_t n = last - first;
+    if (n < 2) return;
+    if (n <= UINT32_MAX) {
+        auto order = sortedKeyIndex<uint32_t>(first, last, proj, comp);
+        applyPermutation(first, order);
+    } else {
+        auto order = sortedKeyIndex<size_t>(first, last, proj, comp);
+        applyPermutation(first, order);
+    }
+}
+
+// 容器版本：sortByKey(shapes, &Shape::getArea)
+template<typename Range, typename Projection, typename Compare = less<>>
+auto sortByKey(Range&& r, Projection proj, Compare comp = Compare()) -> decltype(void(std::begin(r))) {
+    sortByKey(std::begin(r), std::end(r), proj, comp);
+}
+
+// 返回使 [first, last) 按键有序的下标序列，不移动原数据
+template<typename RandomIt, typename Projection = Identity, typename Compare = less<>>
+vector<size_t> argsort(RandomIt first, RandomIt last, Projection proj = Projection(), Compare comp = Compare()) {
+    vector<size_t> result;
+    size_t n = last - first;
+    result.reserve(n);
+    if (n <= UINT32_MAX) {
+        for (const auto& item : sortedKeyIndex<uint32_t>(first, last, proj, comp)) {
+            result.push_back(item.second);
+        }
+    } else {
+        for (const auto& item : sortedKeyIndex<size_t>(first, last, proj, comp)) {
+            result.push_back(item.second);
+        }
+    }
+    return result;
+}
+
+template<typename Range, typename Projection = Identity, typename Compare = less<>>
+auto argsort(Range&& r, Projection proj = Projection(), Compare comp = Compare())
+    -> decltype(std::begin(r), vector<size_t>()) {
+    return argsort(std::begin(r), std::end(r), proj, comp);
+}
+
+// ==================== 性能测试 ====================
+
+// 辅助函数：把记录写入二进制文件
+template<typename T>
+void writeRecords(const string& path, const vector<T>& data) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) throw runtime_error("无法创建文件: " + path);
+    fwrite(data.data(), sizeof(T), data.size(), fp);
+    fclose(fp);
+}
+
+// 辅助函数：从二进制文件读出全部记录
+template<typename T>
+vector<T> readRecords(const string& path) {
+    vector<T> data;
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return data;
+    T buf[4096];
+    size_t got;
+    while ((got = fread(buf, sizeof(T), 4096, fp)) > 0) {
+        data.insert(data.end(), buf, buf + got);
+    }
+    fclose(fp);
+    return data;
+}
+
+// 外部排序吞吐量：128MB 的 uint64 记录，内存预算 16MB
+void benchExternalSort() {
+    cout << "\n[外部归并排序] 128MB uint64 记录, 内存预算 16MB" << endl;
+    const size_t N = 16 * 1024 * 1024;
+    const size_t CHUNK = 1 << 20;
+    mt19937_64 rng(42);
+    vector<unsigned long long> block(CHUNK);
+    FILE* fp = fopen("bench_extsort_in.bin", "wb");
+    if (!fp) throw runtime_error("无法创建测试文件");
+    for (size_t done = 0; done < N; done += CHUNK) {
+        for (auto& x : block) x = rng();
+        fwrite(block.data(), sizeof(block[0]), CHUNK, fp);
+    }
+    fclose(fp);
+
+    ExternalSortStats st = externalSort<unsigned long long>("bench_extsort_in.bin", "bench_extsort_out.bin",
+                                                            16 * 1024 * 1024);
+    cout << "顺串数: " << st.runs << "  归并趟数: " << st.mergePasses << endl;
+    cout << "顺串生成: " << st.runSeconds << " s  归并: " << st.mergeSeconds << " s" << endl;
+    cout << "吞吐量: " << st.throughputMBps(sizeof(unsigned long long)) << " MB/s" << endl;
+    remove("bench_extsort_in.bin");
+    remove("bench_extsort_out.bin");
+}
+
+// Top-K：1000 万个随机整数中取最大的 k 个，与完整排序对比
+void benchTopK() {
+    const int N = 10000000;
+    mt19937 rng(7);
+    vector<int> data(N);
+    for (auto& x : data) x = (int)rng();
+
+    for (int k : {10, 1000, 100000}) {
+        cout << "\n[Top-K] n = " << N << ", k = " << k << endl;
+
+        auto t0 = chrono::steady_clock::now();
+        TopK<int> topk(k);
+        topk.push(data);
+        vector<int> best = topk.sorted();
+        auto t1 = chrono::steady_clock::now();
+
+        vector<int> work(data);
+        auto t2 = chrono::steady_clock::now();
+        partialSort(work.data(), N, k, greater<int>());
+        auto t3 = chrono::steady_clock::now();
+
+        vector<int> full(data);
+        auto t4 = chrono::steady_clock::now();
+        sort(full.data(), N);
+        auto t5 = chrono::steady_clock::now();
+
+        vector<int> full2(data);
+        auto t6 = chrono::steady_clock::now();
+        std::sort(full2.begin(), full2.end());
+        auto t7 = chrono::steady_clock::now();
+
+        bool ok = equal(best.begin(), best.end(), full.rbegin()) &&
+                  equal(work.begin(), work.begin() + k, full.rbegin());
+        auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+            return chrono::duration<double, milli>(b - a).count();
+        };
+        cout << "TopK::push 批量: " << ms(t0, t1) << " ms" << endl;
+        cout << "partialSort:     " << ms(t2, t3) << " ms" << endl;
+        cout << "堆排序 sort:     " << ms(t4, t5) << " ms" << endl;
+        cout << "std::sort:       " << ms(t6, t7) << " ms" << endl;
+        cout << "结果一致: " << (ok ? "是" : "否") << endl;
+    }
+}
+
+// 以 CSR 形式存储的有向带权图
+struct Graph {
+    int n = 0;
+    vector<int> offset;  // 顶点 v 的出边为 [offset[v], offset[v+1])
+    vector<int> target;
+    vector<int> weight;
+};
+
+// 随机生成 n 个顶点、平均出度为 degree 的图，边权为 1~1000
+Graph makeRandomGraph(int n, int degree, unsigned seed) {
+    Graph g;
+    g.n = n;
+    g.offset.resize(n + 1);
+    mt19937 rng(seed);
+    for (int v = 0; v < n; v++) {
+        g.offset[v] = (int)g.target.size();
+        g.target.push_back((v + 1) % n);  // 保证连通
+        g.weight.push_back(1 + (int)(rng() % 1000));
+        for (int e = 1; e < degree; e++) {
+            g.target.push_back((int)(rng() % n));
+            g.weight.push_back(1 + (int)(rng() % 1000));
+        }
+    }
+    g.offset[n] = (int)g.target.size();
+    return g;
+}
+
+// 懒删除版 Dijkstra：允许同一顶点重复入队，出队时跳过过期项
+vector<long long> dijkstraLazy(const Graph& g, int src, size_t& maxQueue) {
+    vector<long long> dist(g.n, LLONG_MAX);
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> pq;
+    dist[src] = 0;
+    pq.push({0, src});
+    maxQueue = 1;
+    while (!pq.empty()) {
+        auto [d, v] = pq.top();
+        pq.pop();
+        if (d > dist[v]) continue;
+        for (int e = g.offset[v]; e < g.offset[v + 1]; e++) {
+            int u = g.target[e];
+            long long nd = d + g.weight[e];
+            if (nd < dist[u]) {
+                dist[u] = nd;
+                pq.push({nd, u});
+            }
+        }
+        maxQueue = max(maxQueue, pq.size());
+    }
+    return dist;
+}
+
+// 索引堆版 Dijkstra：每个顶点至多在队列中出现一次，松弛时 decreaseKey
+template<int D>
+vector<long long> dijkstraIndexed(const Graph& g, int src, size_t& maxQueue) {
+    vector<long long> dist(g.n, LLONG_MAX);
+    IndexedPriorityQueue<long long, D> pq(g.n);
+    dist[src] = 0;
+    pq.push(src, 0);
+    maxQueue = 1;
+    while (!pq.empty()) {
+        int v = pq.pop();
+        long long d = dist[v];
+        for (int e = g.offset[v]; e < g.offset[v + 1]; e++) {
+            int u = g.target[e];
+            long long nd = d + g.weight[e];
+            if (nd < dist[u]) {
+                if (pq.contains(u)) {
+                    pq.decreaseKey(u, nd);
+                } else {
+                    pq.push(u, nd);
+                }
+                dist[u] = nd;
+            }
+        }
+        maxQueue = max(maxQueue, (size_t)pq.size());
+    }
+    return dist;
+}
+
+// Dijkstra：懒删除与索引堆（2 叉 / 4 叉 / 8 叉）对比
+void benchDijkstra() {
+    for (int degree : {4, 16}) {
+        const int N = 1000000;
+        Graph g = makeRandomGraph(N, degree, 11);
+        cout << "\n[Dijkstra] 顶点 " << N << ", 边 " << g.target.size() << endl;
+
+        size_t q0, q2, q4, q8;
+        auto t0 = chrono::steady_clock::now();
+        vector<long long> d0 = dijkstraLazy(g, 0, q0);
+        auto t1 = chrono::steady_clock::now();
+        vector<long long> d2 = dijkstraIndexed<2>(g, 0, q2);
+        auto t2 = chrono::steady_clock::now();
+        vector<long long> d4 = dijkstraIndexed<4>(g, 0, q4);
+        auto t3 = chrono::steady_clock::now();
+        vector<long long> d8 = dijkstraIndexed<8>(g, 0, q8);
+        auto t4 = chrono::steady_clock::now();
+
+        auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+            return chrono::duration<double, milli>(b - a).count();
+        };
+        cout << "懒删除 priority_queue: " << ms(t0, t1) << " ms, 队列峰值 " << q0 << endl;
+        cout << "索引堆 D=2:            " << ms(t1, t2) << " ms, 队列峰值 " << q2 << endl;
+        cout << "索引堆 D=4:            " << ms(t2, t3) << " ms, 队列峰值 " << q4 << endl;
+        cout << "索引堆 D=8:            " << ms(t3, t4) << " ms, 队列峰值 " << q8 << endl;
+        cout << "结果一致: " << (d0 == d2 && d0 == d4 && d0 == d8 ? "是" : "否") << endl;
+    }
+}
+
+// 按键排序：以虚函数计算面积的多边形，面积计算代价较高
+struct BenchShape {
+    virtual ~BenchShape() = default;
+    virtual double getArea() const = 0;
+};
+
+struct BenchPolygon : BenchShape {
+    vector<double> xs, ys;
+
+    // 鞋带公式，顶点越多键越“贵”
+    double getArea() const override {
+        double sum = 0;
+        size_t n = xs.size();
+        for (size_t i = 0; i < n; i++) {
+            size_t j = (i + 1) % n;
+            sum += xs[i] * ys[j] - xs[j] * ys[i];
+        }
+        return fabs(sum) / 2;
+    }
+};
+
+void benchSortByKey() {
+    const int N = 200000;
+    const int VERTICES = 32;
+    cout << "\n[按键排序] " << N << " 个 " << VERTICES << " 边形, 键为虚函数 getArea()" << endl;
+
+    mt19937 rng(3);
+    uniform_real_distribution<double> radius(1.0, 100.0);
+    vector<unique_ptr<BenchPolygon>> storage;
+    vector<BenchShape*> shapes;
+    for (int i = 0; i < N; i++) {
+        storage.emplace_back(new BenchPolygon());
+        double r = radius(rng);
+        for (int v = 0; v < VERTICES; v++) {
+            double a = 2 * 3.14159265358979 * v / VERTICES;
+            storage.back()->xs.push_back(r * cos(a));
+            storage.back()->ys.push_back(r * sin(a));
+        }
+        shapes.push_back(storage.back().get());
+    }
+
+    vector<BenchShape*> a(shapes), b(shapes);
+    auto t0 = chrono::steady_clock::now();
+    std::stable_sort(a.begin(), a.end(), [](const BenchShape* x, const BenchShape* y) {
+        return x->getArea() < y->getArea();
+    });
+    auto t1 = chrono::steady_clock::now();
+    sortByKey(b, &BenchShape::getArea);
+    auto t2 = chrono::steady_clock::now();
+    vector<size_t> idx = argsort(shapes, &BenchShape::getArea);
+    auto t3 = chrono::steady_clock::now();
+
+    bool ok = a == b;
+    for (int i = 0; i < N && ok; i++) ok = shapes[idx[i]] == b[i];
+    auto ms = [](chrono::steady_clock::time_point x, chrono::steady_clock::time_point y) {
+        return chrono::duration<double, milli>(y - x).count();
+    };
+    cout << "std::stable_sort 比较时计算键: " << ms(t0, t1) << " ms" << endl;
+    cout << "sortByKey:                     " << ms(t1, t2) << " ms" << endl;
+    cout << "argsort:                       " << ms(t2, t3) << " ms" << endl;
+    cout << "结果一致: " << (ok ? "是" : "否") << endl;
+}
+
+// 原递归版 print，仅用于性能对比：每个参数单独经过流格式化，每行 endl 刷新
+void printRecursive(ostream& os) {
+    os << endl;
+}
+
+template<typename T, typename... Args>
+void printRecursive(ostream& os, T first, Args... args) {
+    os << first;
     if (sizeof...(args) > 0) {
-        cout << " ";  // 参数之间用空格分隔
+        os << " ";
+    }
+    printRecursive(os, args...);
+}
+
+// print：逐行输出 100 万行混合类型日志，对比原递归版本
+void benchPrint() {
+    const int LINES = 1000000;
+    cout << "\n[print] " << LINES << " 行混合类型输出" << endl;
+
+    auto t0 = chrono::steady_clock::now();
+    {
+        ofstream ofs("bench_print_old.txt");
+        for (int i = 0; i < LINES; i++) {
+            printRecursive(ofs, "event", i, i * 0.001, 'K', "status", i % 7 == 0);
+        }
     }
-    print(args...);  // 递归处理剩余参数
+    auto t1 = chrono::steady_clock::now();
+    {
+        FILE* fp = fopen("bench_print_new.txt", "wb");
+        if (!fp) throw runtime_error("无法创建测试文件");
+        {
+            PrintBatch batch(fp);
+            for (int i = 0; i < LINES; i++) {
+                print("event", i, i * 0.001, 'K', "status", i % 7 == 0);
+            }
+        }
+        fclose(fp);
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    ifstream a("bench_print_old.txt", ios::binary), b("bench_print_new.txt", ios::binary);
+    bool same = equal(istreambuf_iterator<char>(a), istreambuf_iterator<char>(),
+                      istreambuf_iterator<char>(b), istreambuf_iterator<char>());
+    a.close();
+    b.close();
+
+    double oldSec = chrono::duration<double>(t1 - t0).count();
+    double newSec = chrono::duration<double>(t2 - t1).count();
+    cout << "递归版 (ostream + endl): " << LINES / oldSec << " 行/秒" << endl;
+    cout << "折叠表达式 + 缓冲:       " << LINES / newSec << " 行/秒" << endl;
+    cout << "输出一致: " << (same ? "是" : "否") << endl;
+    remove("bench_print_old.txt");
+    remove("bench_print_new.txt");
+}
+
+// 辅助函数：统计延迟分位数（纳秒）
+double percentile(vector<double>& samples, double q) {
+    if (samples.empty()) return 0;
+    size_t k = (size_t)(q * (samples.size() - 1));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+// 异步日志：1~32 个线程同时 print，统计生产者端单次调用延迟
+void benchAsyncLog() {
+    const int PER_THREAD = 20000;
+    cout << "\n[异步日志] 每线程 " << PER_THREAD << " 条, 生产者端延迟 (ns)" << endl;
+    cout << "线程数\t同步p50\t同步p99\t异步p50\t异步p99\t丢弃(Drop策略)" << endl;
+
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        vector<vector<double>> syncLat(threads), asyncLat(threads);
+
+        // 同步基线：共享文件流 + 互斥锁，每行 endl
+        {
+            ofstream ofs("bench_log_sync.txt");
+            mutex m;
+            vector<thread> pool;
+            for (int t = 0; t < threads; t++) {
+                pool.emplace_back([&, t]() {
+                    syncLat[t].reserve(PER_THREAD);
+                    for (int i = 0; i < PER_THREAD; i++) {
+                        auto a = chrono::steady_clock::now();
+                        {
+                            lock_guard<mutex> lock(m);
+                            printRecursive(ofs, "worker", t, "seq", i, "value", i * 0.5);
+                        }
+                        auto b = chrono::steady_clock::now();
+                        syncLat[t].push_back(chrono::duration<double, nano>(b - a).count());
+                    }
+                });
+            }
+            for (auto& th : pool) th.join();
+        }
+
+        // 异步模式
+        for (OverflowPolicy policy : {OverflowPolicy::Block, OverflowPolicy::Drop}) {
+            FILE* fp = fopen("bench_log_async.txt", "wb");
+            if (!fp) throw runtime_error("无法创建测试文件");
+            AsyncLogger::start(fp, policy, 256 * 1024);
+            vector<thread> pool;
+            for (int t = 0; t < threads; t++) {
+                pool.emplace_back([&, t]() {
+                    vector<double>& lat = asyncLat[t];
+                    lat.reserve(PER_THREAD);
+                    for (int i = 0; i < PER_THREAD; i++) {
+                        auto a = chrono::steady_clock::now();
+                        print("worker", t, "seq", i, "value", i * 0.5);
+                        auto b = chrono::steady_clock::now();
+                        if (policy == OverflowPolicy::Block) {
+                            lat.push_back(chrono::duration<double, nano>(b - a).count());
+                        }
+                    }
+                });
+            }
+            for (auto& th : pool) th.join();
+            size_t dropped = AsyncLogger::droppedCount();
+            AsyncLogger::stop();
+            fclose(fp);
+
+            if (policy == OverflowPolicy::Drop) {
+                vector<double> s, a;
+                for (auto& v : syncLat) s.insert(s.end(), v.begin(), v.end());
+                for (auto& v : asyncLat) a.insert(a.end(), v.begin(), v.end());
+                cout << threads << "\t" << percentile(s, 0.5) << "\t" << percentile(s, 0.99) << "\t"
+                     << percentile(a, 0.5) << "\t" << percentile(a, 0.99) << "\t" << dropped << endl;
+            }
+        }
+    }
+    remove("bench_log_sync.txt");
+    remove("bench_log_async.txt");
+}
+
+void runBenchmarks() {
+    cout << "========== 性能测试 ==========" << endl;
+    benchExternalSort();
+    benchTopK();
+    benchDijkstra();
+    benchSortByKey();
+    benchPrint();
+    benchAsyncLog();
 }
 
 // ==================== 主函数：测试代码 ====================
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        runBenchmarks();
+        return 0;
+    }
+
     // ========== 任务1测试：堆排序函数模板 ==========
     cout << "【任务1】堆排序函数模板测试" << endl;
     cout << "----------------------------------------" << endl;
@@ -157,6 +1811,160 @@ int main() {
     cout << "输出: ";
     print();
 
+    // 测试6：异步模式
+    cout << "\n测试6：异步模式" << endl;
+    cout << "输出: ";
+    AsyncLogger::start();
+    print("async", 7, 2.5, 'Z', true);
+    AsyncLogger::flush();
+    AsyncLogger::stop();
+
+    // 测试7：异步模式下多线程写文件，各行完整不交错
+    cout << "\n测试7：4 个线程各写 1000 行" << endl;
+    {
+        FILE* fp = fopen("async_log.txt", "wb");
+        AsyncLogger::start(fp);
+        vector<thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([t]() {
+                for (int i = 0; i < 1000; i++) {
+                    print("thread", t, "line", i);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        AsyncLogger::stop();
+        fclose(fp);
+
+        ifstream ifs("async_log.txt");
+        string line;
+        int lines = 0, wellFormed = 0;
+        while (getline(ifs, line)) {
+            lines++;
+            if (line.rfind("thread ", 0) == 0 && line.find(" line ") != string::npos) wellFormed++;
+        }
+        ifs.close();
+        cout << "行数: " << lines << "  格式完整: " << wellFormed << endl;
+        remove("async_log.txt");
+    }
+
+    cout << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // ========== 任务3测试：外部归并排序 ==========
+    cout << "【任务3】外部归并排序测试" << endl;
+    cout << "----------------------------------------" << endl;
+
+    // 测试：10万个随机整数，内存预算 64KB，每趟最多归并 4 路
+    cout << "\n测试1：小内存预算下的多趟归并" << endl;
+    {
+        mt19937 rng(2024);
+        vector<unsigned> data(100000);
+        for (auto& x : data) x = rng();
+        writeRecords("extsort_in.bin", data);
+
+        ExternalSortStats st = externalSort<unsigned>("extsort_in.bin", "extsort_out.bin", 64 * 1024, 4, ".", 4);
+        vector<unsigned> result = readRecords<unsigned>("extsort_out.bin");
+        std::sort(data.begin(), data.end());
+
+        cout << "记录数: " << st.records << "  顺串数: " << st.runs
+             << "  归并趟数: " << st.mergePasses << endl;
+        cout << "结果正确: " << (result == data ? "是" : "否") << endl;
+        remove("extsort_in.bin");
+        remove("extsort_out.bin");
+    }
+
+    cout << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // ========== 任务4测试：Top-K 与部分排序 ==========
+    cout << "【任务4】Top-K 与部分排序测试" << endl;
+    cout << "----------------------------------------" << endl;
+
+    // 测试1：部分排序，取最小的 3 个
+    cout << "\n测试1：部分排序（k=3）" << endl;
+    int partArr[] = {64, 34, 25, 12, 22, 11, 90, 5};
+    int n6 = sizeof(partArr) / sizeof(partArr[0]);
+    partialSort(partArr, n6, 3);
+    cout << "前3小: ";
+    printArray(partArr, 3);
+
+    // 测试2：第 k 小元素
+    cout << "\n测试2：第 k 小元素选择" << endl;
+    double nthArr[] = {3.14, 2.71, 1.41, 0.57, 4.67, 1.73};
+    int n7 = sizeof(nthArr) / sizeof(nthArr[0]);
+    nthElement(nthArr, n7, 2);
+    cout << "第3小: " << nthArr[2] << endl;
+
+    // 测试3：流式 Top-K，按面积取最大的 3 个图形
+    cout << "\n测试3：按面积取最大的3个图形" << endl;
+    struct ShapeArea {
+        string name;
+        double area;
+    };
+    auto byArea = [](const ShapeArea& a, const ShapeArea& b) { return a.area < b.area; };
+    TopK<ShapeArea, decltype(byArea)> largest(3, byArea);
+    ShapeArea shapeArr[] = {
+        {"圆r=5", 78.54}, {"矩形4x6", 24}, {"三角形3x4", 6},
+        {"圆r=2", 12.57}, {"矩形10x10", 100}, {"正方形7", 49}
+    };
+    largest.push(shapeArr, sizeof(shapeArr) / sizeof(shapeArr[0]));
+    cout << "输出: ";
+    for (const auto& s : largest.sorted()) {
+        cout << s.name << "(" << s.area << ") ";
+    }
+    cout << endl;
+
+    cout << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // ========== 任务5测试：索引优先队列 ==========
+    cout << "【任务5】索引优先队列测试" << endl;
+    cout << "----------------------------------------" << endl;
+
+    // 测试：任务调度，句柄为任务编号，键为截止时间
+    cout << "\n测试1：按截止时间调度任务" << endl;
+    IndexedPriorityQueue<int> tasks(6);
+    int deadlines[] = {50, 20, 40, 10, 30, 60};
+    for (int i = 0; i < 6; i++) {
+        tasks.push(i, deadlines[i]);
+    }
+    tasks.decreaseKey(5, 5);   // 任务5 提前到 5
+    tasks.increaseKey(3, 45);  // 任务3 推迟到 45
+    tasks.erase(2);            // 取消任务2
+    cout << "调度顺序(任务:截止时间): ";
+    while (!tasks.empty()) {
+        int h = tasks.top();
+        cout << h << ":" << tasks.topKey() << " ";
+        tasks.pop();
+    }
+    cout << endl;
+
+    cout << endl;
+    cout << "----------------------------------------" << endl;
+    cout << endl;
+
+    // ========== 任务6测试：按键排序 ==========
+    cout << "【任务6】按投影键排序测试" << endl;
+    cout << "----------------------------------------" << endl;
+
+    // 测试1：字符串按长度稳定排序
+    cout << "\n测试1：字符串按长度排序" << endl;
+    vector<string> words = {"banana", "fig", "apple", "kiwi", "cherry", "date"};
+    sortByKey(words, [](const string& w) { return w.size(); });
+    cout << "输出: ";
+    printArray(words.data(), (int)words.size());
+
+    // 测试2：argsort，返回降序排列的下标
+    cout << "\n测试2：argsort（降序）" << endl;
+    double scores[] = {3.14, 2.71, 1.41, 0.57, 4.67, 1.73};
+    vector<size_t> order = argsort(begin(scores), end(scores), Identity(), greater<>());
+    cout << "下标: ";
+    printArray(order.data(), (int)order.size());
+
     cout << endl;
     cout << "----------------------------------------" << endl;
     cout << "========== 实验完成 ==========" << endl;
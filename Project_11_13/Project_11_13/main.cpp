@@ -2,7 +2,8 @@
  * 实验二：继承、派生、多态性
  * 功能：实现抽象图形基类Shape，以及Circle, Square, Parallelogram, EquilateralTriangle, RegularHexagon等派生类
  *      并实现其面积、周长、绘制、变换等操作。
- * 使用EGE图形库进行可视化
+ * 使用EGE图形库进行可视化；编译时定义 SHAPE_TRACE 可统计各图形虚函数的调用耗时并导出 Chrome trace
+ * 运行 main --bench 执行性能测试；main --animate [图形数] [帧数] [--headless] 运行连续动画并导出帧时间
  */
 
 #include <graphics.h>
@@ -11,6 +12,13 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <chrono>
+#include <malloc.h>
+#include <algorithm>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
 
 using namespace std;
 
@@ -22,7 +30,131 @@ const int WINDOW_HEIGHT = 800;
 class Point;
 
 //==============================================================================
-// 1. 抽象基类 Shape
+// 0. 内存池：64 字节对齐、按大小分级缓存，供多边形顶点缓冲区使用（本程序单线程，不加锁）
+//==============================================================================
+struct PoolStats {
+    size_t requests = 0;      // allocate 调用次数
+    size_t systemAllocs = 0;  // 实际向系统申请的次数
+    size_t systemFrees = 0;   // 归还给系统的次数
+    size_t cachedBytes = 0;   // 当前缓存在空闲链表中的字节数
+};
+
+// 只能在单线程中使用：空闲链表和计数都没有加锁，多个线程同时创建或销毁 Polygon 会破坏链表；
+// 以后若要在工作线程中构造图形，需给 allocate/deallocate 加锁或改为每线程一个池
+class AlignedPool {
+public:
+    static const size_t ALIGNMENT = 64;
+
+private:
+    static const int CLASS_COUNT = 4 * 58 + 1;
+
+    vector<void*> freeLists[CLASS_COUNT];
+    PoolStats counters;
+    size_t maxCachedBytes = (size_t)64 << 20;  // 空闲链表最多缓存的字节数，超出部分直接归还系统
+
+    // 64 字节以内为第 0 级；更大的块在每个 2 的幂区间内再分 4 级
+    static int sizeClass(size_t bytes, size_t& rounded) {
+        if (bytes <= 64) {
+            rounded = 64;
+            return 0;
+        }
+        int e = 6;
+        while (((size_t)1 << (e + 1)) < bytes) e++;  // 2^e < bytes <= 2^(e+1)
+        size_t step = (size_t)1 << (e - 2);
+        rounded = (bytes + step - 1) & ~(step - 1);
+        int k = (int)((rounded - ((size_t)1 << e)) / step);
+        return 1 + (e - 6) * 4 + (k - 1);
+    }
+
+    AlignedPool() = default;
+
+public:
+    AlignedPool(const AlignedPool&) = delete;
+    AlignedPool& operator=(const AlignedPool&) = delete;
+
+    // 有意不析构：静态对象中的图形可能在它之后才释放顶点
+    static AlignedPool& instance() {
+        static AlignedPool* pool = new AlignedPool();
+        return *pool;
+    }
+
+    void* allocate(size_t bytes) {
+        size_t rounded;
+        int cls = sizeClass(max<size_t>(bytes, 1), rounded);
+        counters.requests++;
+        vector<void*>& list = freeLists[cls];
+        if (!list.empty()) {
+            void* p = list.back();
+            list.pop_back();
+            counters.cachedBytes -= rounded;
+            return p;
+        }
+        void* p = _aligned_malloc(rounded, ALIGNMENT);
+        if (!p) throw bad_alloc();
+        counters.systemAllocs++;
+        return p;
+    }
+
+    // bytes 必须与 allocate 时相同
+    void deallocate(void* p, size_t bytes) {
+        if (!p) return;
+        size_t rounded;
+        int cls = sizeClass(max<size_t>(bytes, 1), rounded);
+        if (counters.cachedBytes + rounded > maxCachedBytes) {
+            _aligned_free(p);
+            counters.systemFrees++;
+            return;
+        }
+        freeLists[cls].push_back(p);
+        counters.cachedBytes += rounded;
+    }
+
+    PoolStats stats() {
+        return counters;
+    }
+
+    void setMaxCachedBytes(size_t bytes) {
+        maxCachedBytes = bytes;
+    }
+};
+
+template<typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(AlignedPool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        AlignedPool::instance().deallocate(p, n * sizeof(T));
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+//==============================================================================
+// 1. 绘制命令队列：DrawCommand、RenderBackend（EgeBackend/CountingBackend）与 RenderQueue，与实验一共用
+//==============================================================================
+
+#include "../../Shared/render_queue.h"
+
+//==============================================================================
+// 2. 调用追踪：TRACE_TYPE / TRACE_CALL / TRACE_SPAN / TRACE_REPORT，与实验一共用；定义 SHAPE_TRACE 才启用
+//==============================================================================
+
+#include "../../Shared/shape_trace.h"
+
+//==============================================================================
+// 3. 抽象基类 Shape
 //==============================================================================
 class Shape {
 protected:
@@ -30,6 +162,9 @@ protected:
     static void rotatePointAround(Point& p, const Point& center, double angle);
     static void mirrorPointAround(Point& p, const Point& center, bool horizontal);
     static void scalePointAround(Point& p, const Point& center, double factor);
+#ifdef SHAPE_TRACE
+    virtual const char* traceName() const = 0;  // 由各图形类里的 TRACE_TYPE 生成
+#endif
 
 public:
     Shape() = default;
@@ -38,7 +173,7 @@ public:
     // 纯虚函数，定义接口
     virtual double getArea() const = 0;
     virtual double getPerimeter() const = 0;
-    virtual void draw(color_t color) const = 0;
+    virtual void draw(RenderQueue& queue, color_t color) const = 0;  // 只记录绘制命令
     virtual void move(double dx, double dy) = 0;
     virtual void rotate(double angle) = 0;
     virtual void scale(double factor) = 0;
@@ -46,7 +181,7 @@ public:
 };
 
 //==============================================================================
-// 2. Point 类 (作为辅助类，不继承Shape)
+// 4. Point 类 (作为辅助类，不继承Shape)
 //==============================================================================
 class Point {
 private:
@@ -96,7 +231,7 @@ void Shape::scalePointAround(Point& p, const Point& center, double factor) {
 }
 
 //==============================================================================
-// 3. 派生类
+// 5. 派生类
 //==============================================================================
 
 //------------------------- Circle 圆形 -------------------------
@@ -106,23 +241,25 @@ private:
     double radius;
 
 public:
+    TRACE_TYPE(Circle)
+
     Circle(const Point& c, double r) : center(c), radius(r) {}
     Circle(double x, double y, double r) : center(x, y), radius(r) {}
 
-    double getArea() const override { return MY_PI * radius * radius; }
+    double getArea() const override { TRACE_CALL(GetArea); return MY_PI * radius * radius; }
     double getPerimeter() const override { return 2 * MY_PI * radius; }
 
-    void draw(color_t color) const override {
-        setcolor(color);
-        setlinewidth(2);
-        circle((int)center.getX(), (int)center.getY(), (int)radius);
+    void draw(RenderQueue& queue, color_t color) const override {
+        TRACE_CALL(Draw);
+        queue.addCircle((int)center.getX(), (int)center.getY(), (int)radius, color, 2);
     }
 
-    void move(double dx, double dy) override { center.move(dx, dy); }
-    void rotate(double angle) override { /* 圆绕自身中心旋转不变 */ }
-    void scale(double factor) override { radius *= factor; }
+    void move(double dx, double dy) override { TRACE_CALL(Move); center.move(dx, dy); }
+    void rotate(double angle) override { TRACE_CALL(Rotate); /* 圆绕自身中心旋转不变 */ }
+    void scale(double factor) override { TRACE_CALL(Scale); radius *= factor; }
 
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "圆: 中心(" << center.getX() << ", " << center.getY() << "), 半径 " << radius
             << " | 面积: " << getArea() << " | 周长: " << getPerimeter();
@@ -131,12 +268,15 @@ public:
 };
 
 //------------------------- Polygon 多边形 (作为其他多边形的虚基类) -------------------------
-class Polygon : public virtual Shape {
+// Alloc 决定顶点缓冲区的分配方式，模板默认为 std::allocator；
+// 下面的别名 Polygon 指定了 AlignedAllocator，程序中的多边形都从 64 字节对齐的内存池分配顶点
+template<typename Alloc = allocator<Point>>
+class BasicPolygon : public virtual Shape {
 protected:
-    vector<Point> vertices;
+    vector<Point, Alloc> vertices;
 
 public:
-    Polygon(const vector<Point>& v) : vertices(v) {}
+    BasicPolygon(const vector<Point>& v) : vertices(v.begin(), v.end()) {}
 
     Point getCenter() const {
         double sumX = 0, sumY = 0;
@@ -148,12 +288,14 @@ public:
     }
 
     void move(double dx, double dy) override {
+        TRACE_CALL(Move);
         for (auto& v : vertices) {
             v.move(dx, dy);
         }
     }
 
     void rotate(double angle) override {
+        TRACE_CALL(Rotate);
         Point center = getCenter();
         for (auto& v : vertices) {
             rotatePointAround(v, center, angle);
@@ -161,27 +303,31 @@ public:
     }
 
     void scale(double factor) override {
+        TRACE_CALL(Scale);
         Point center = getCenter();
         for (auto& v : vertices) {
             scalePointAround(v, center, factor);
         }
     }
 
-    void draw(color_t color) const override {
-        setcolor(color);
-        setlinewidth(2);
+    void draw(RenderQueue& queue, color_t color) const override {
+        TRACE_CALL(Draw);
         if (vertices.size() < 2) return;
         for (size_t i = 0; i < vertices.size(); ++i) {
             const Point& p1 = vertices[i];
             const Point& p2 = vertices[(i + 1) % vertices.size()];
-            line((int)p1.getX(), (int)p1.getY(), (int)p2.getX(), (int)p2.getY());
+            queue.addLine((int)p1.getX(), (int)p1.getY(), (int)p2.getX(), (int)p2.getY(), color, 2);
         }
     }
 };
 
+using Polygon = BasicPolygon<AlignedAllocator<Point>>;
+
 //------------------------- Parallelogram 平行四边形 -------------------------
 class Parallelogram : public Polygon {
 public:
+    TRACE_TYPE(Parallelogram)
+
     // 构造函数：p1为左下角，p2为右下角，p3为右上角
     // 第四个点p4（左上角）= p1 + (p3 - p2)
     // 顶点顺序：p1(左下) -> p2(右下) -> p3(右上) -> p4(左上)
@@ -190,6 +336,7 @@ public:
     }
 
     double getArea() const override {
+        TRACE_CALL(GetArea);
         // 使用向量叉积计算平行四边形面积
         const Point& p1 = vertices[0];
         const Point& p2 = vertices[1];
@@ -202,6 +349,7 @@ public:
     }
 
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "平行四边形 | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
@@ -211,6 +359,8 @@ public:
 //------------------------- Square 正方形 (保护继承自Parallelogram，同时公有继承Shape以支持多态) -------------------------
 class Square : protected Parallelogram, virtual public Shape {
 public:
+    TRACE_TYPE(Square)
+
     Square(const Point& center, double side)
         : Parallelogram(
             Point(center.getX() - side / 2, center.getY() - side / 2),
@@ -225,10 +375,11 @@ public:
     using Polygon::rotate;
     using Polygon::scale;
 
-    double getArea() const override { return Parallelogram::getArea(); }
+    double getArea() const override { return Parallelogram::getArea(); }  // 由 Parallelogram::getArea 记录
     double getPerimeter() const override { return Parallelogram::getPerimeter(); }
 
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "正方形 | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
@@ -238,6 +389,8 @@ public:
 //------------------------- EquilateralTriangle 正三角形 -------------------------
 class EquilateralTriangle : public Polygon {
 public:
+    TRACE_TYPE(EquilateralTriangle)
+
     EquilateralTriangle(const Point& center, double side) : Polygon({}) {
         double h = side * sqrt(3.0) / 2.0;
         vertices.push_back(Point(center.getX(), center.getY() - 2.0 * h / 3.0));
@@ -245,10 +398,11 @@ public:
         vertices.push_back(Point(center.getX() + side / 2.0, center.getY() + h / 3.0));
     }
 
-    double getArea() const override { return pow(vertices[0].distanceTo(vertices[1]), 2) * sqrt(3.0) / 4.0; }
+    double getArea() const override { TRACE_CALL(GetArea); return pow(vertices[0].distanceTo(vertices[1]), 2) * sqrt(3.0) / 4.0; }
     double getPerimeter() const override { return 3 * vertices[0].distanceTo(vertices[1]); }
 
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "正三角形 | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
@@ -258,6 +412,8 @@ public:
 //------------------------- RegularHexagon 正六边形 -------------------------
 class RegularHexagon : public Polygon {
 public:
+    TRACE_TYPE(RegularHexagon)
+
     RegularHexagon(const Point& center, double side) : Polygon({}) {
         for (int i = 0; i < 6; ++i) {
             double angle_rad = MY_PI / 180.0 * (60 * i);
@@ -265,10 +421,11 @@ public:
         }
     }
 
-    double getArea() const override { return 3.0 * sqrt(3.0) / 2.0 * pow(vertices[0].distanceTo(getCenter()), 2); }
+    double getArea() const override { TRACE_CALL(GetArea); return 3.0 * sqrt(3.0) / 2.0 * pow(vertices[0].distanceTo(getCenter()), 2); }
     double getPerimeter() const override { return 6 * vertices[0].distanceTo(getCenter()); }
 
     string getInfo() const override {
+        TRACE_CALL(GetInfo);
         ostringstream oss;
         oss << "正六边形 | 面积: " << getArea() << " | 周长: " << getPerimeter();
         return oss.str();
@@ -277,7 +434,7 @@ public:
 
 
 //==============================================================================
-// 4. 辅助绘图函数
+// 6. 辅助绘图函数
 //==============================================================================
 void drawText(int x, int y, const string& text, color_t color = WHITE) {
     setcolor(color);
@@ -291,8 +448,16 @@ void drawTitle(const string& title, int y) {
     outtextxy(20, y, title.c_str());
 }
 
+// 提交一帧的绘制命令，并在窗口底部显示本帧的命令数与状态切换次数
+void presentFrame(RenderQueue& queue, RenderBackend& backend) {
+    RenderStats stats = queue.flush(backend);
+    ostringstream oss;
+    oss << "绘制命令: " << stats.primitives << " 条, 状态切换 " << stats.stateChanges << " 次";
+    drawText(WINDOW_WIDTH - 360, WINDOW_HEIGHT - 40, oss.str(), LIGHTGREEN);
+}
+
 //==============================================================================
-// 5. 工具函数：创建初始图形 & 释放图形
+// 7. 工具函数：创建初始图形 & 释放图形
 //==============================================================================
 vector<Shape*> createInitialShapes() {
     vector<Shape*> shapes;
@@ -313,12 +478,184 @@ void destroyShapes(vector<Shape*>& shapes) {
 }
 
 //==============================================================================
-// 6. 主函数 main
+// 8. 动画：固定步长更新姿态，按插值姿态绘制，逐帧统计更新与绘制耗时
+//==============================================================================
+#include "../../Shared/shape_animation.h"
+
+// populateScene：轮流放圆、正方形、平行四边形、正三角形、正六边形，每个图形的中心即姿态位置
+void populateScene(AnimationScene& scene, int count, unsigned seed) {
+    const color_t PALETTE[] = { WHITE, RED, YELLOW, LIGHTGREEN, LIGHTCYAN };
+    const int COLORS = sizeof(PALETTE) / sizeof(PALETTE[0]);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> posX(40, WINDOW_WIDTH - 40), posY(80, WINDOW_HEIGHT - 40);
+    uniform_real_distribution<double> speed(-120, 120), spin(-90, 90), pulse(0.5, 2.0), phase(0, 2 * MY_PI);
+    for (int i = 0; i < count; i++) {
+        double x = posX(rng), y = posY(rng);
+        Shape* shape;
+        switch (i % 5) {
+        case 0: shape = new Circle(x, y, 10); break;
+        case 1: shape = new Square(Point(x, y), 20); break;
+        case 2: shape = new Parallelogram(Point(x - 12, y + 6), Point(x + 8, y + 6), Point(x + 12, y - 6)); break;
+        case 3: shape = new EquilateralTriangle(Point(x, y), 22); break;
+        default: shape = new RegularHexagon(Point(x, y), 11); break;
+        }
+        Motion motion = { speed(rng), speed(rng), spin(rng), pulse(rng), phase(rng) };
+        scene.add(shape, x, y, motion, PALETTE[i % COLORS]);
+    }
+}
+
+//==============================================================================
+// 9. 性能测试：顶点缓冲区使用内存池与默认分配器的对比；逐个提交与排序合并后提交绘制命令的对比；动画主循环的帧时间
+//==============================================================================
+template<typename Alloc>
+class BenchPolygon : public BasicPolygon<Alloc> {
+public:
+    TRACE_TYPE(BenchPolygon)
+
+    BenchPolygon(const vector<Point>& v) : BasicPolygon<Alloc>(v) {}
+
+    double getArea() const override {
+        TRACE_CALL(GetArea);
+        double sum = 0;
+        const auto& v = this->vertices;
+        for (size_t i = 0; i < v.size(); ++i) {
+            const Point& p1 = v[i];
+            const Point& p2 = v[(i + 1) % v.size()];
+            sum += p1.getX() * p2.getY() - p2.getX() * p1.getY();
+        }
+        return abs(sum) / 2;
+    }
+
+    double getPerimeter() const override { return 0; }
+    string getInfo() const override { TRACE_CALL(GetInfo); return "多边形"; }
+};
+
+// 反复创建、变换、销毁一批多边形，统计耗时与系统分配次数
+template<typename Alloc>
+double runPolygonChurn(int rounds, int count, const vector<Point>& shape, double& checksum) {
+    TRACE_SPAN("runPolygonChurn");
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        vector<Shape*> shapes;
+        for (int i = 0; i < count; i++) {
+            shapes.push_back(new BenchPolygon<Alloc>(shape));
+            shapes.back()->move(i, r);
+            shapes.back()->rotate(15);
+        }
+        for (auto s : shapes) checksum += s->getArea();
+        destroyShapes(shapes);
+    }
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+// 逐个图形立即提交（原 draw() 的做法）与整帧按状态分桶后提交的对比
+// 无窗口时用计数后端，只统计状态切换与调用次数，耗时为记录 + 分桶 + 提交的 CPU 时间
+void benchRenderQueue() {
+    TRACE_SPAN("benchRenderQueue");
+    const int COUNT = 20000;
+    const int FRAMES = 30;
+    const color_t PALETTE[] = { WHITE, RED, YELLOW, LIGHTGREEN, LIGHTCYAN, EGERGB(255, 128, 0), EGERGB(128, 0, 255), EGERGB(0, 128, 255) };
+    const int COLORS = sizeof(PALETTE) / sizeof(PALETTE[0]);
+
+    vector<Shape*> shapes;
+    vector<color_t> colors;
+    for (int i = 0; i < COUNT; i++) {
+        Point c((i % 200) * 6.0, (i / 200) * 8.0);
+        switch (i % 5) {
+        case 0: shapes.push_back(new Circle(c, 3)); break;
+        case 1: shapes.push_back(new Square(c, 4)); break;
+        case 2: shapes.push_back(new Parallelogram(c, Point(c.getX() + 4, c.getY()), Point(c.getX() + 5, c.getY() + 3))); break;
+        case 3: shapes.push_back(new EquilateralTriangle(c, 4)); break;
+        default: shapes.push_back(new RegularHexagon(c, 2)); break;
+        }
+        colors.push_back(PALETTE[(i * 7) % COLORS]);
+    }
+    cout << "[绘制命令队列] " << COUNT << " 个图形, " << COLORS << " 种颜色, " << FRAMES << " 帧, sizeof(DrawCommand) = "
+         << sizeof(DrawCommand) << endl;
+
+    RenderQueue queue;
+    CountingBackend immediate, batched;
+    RenderStats before, after;
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < COUNT; i++) {
+            shapes[i]->draw(queue, colors[i]);
+            RenderStats st = queue.flush(immediate, false);
+            before.primitives += st.primitives;
+            before.stateChanges += st.stateChanges;
+        }
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < COUNT; i++) {
+            shapes[i]->draw(queue, colors[i]);
+        }
+        RenderStats st = queue.flush(batched);
+        after.primitives += st.primitives;
+        after.stateChanges += st.stateChanges;
+        after.batches += st.batches;
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cout << "逐个提交: " << before.primitives / FRAMES << " 图元/帧, 状态切换 " << before.stateChanges / FRAMES
+         << " 次/帧, 后端调用 " << immediate.calls / FRAMES << " 次/帧, " << ms(t0, t1) / FRAMES << " ms/帧" << endl;
+    cout << "分桶合并: " << after.primitives / FRAMES << " 图元/帧, 状态切换 " << after.stateChanges / FRAMES
+         << " 次/帧, 后端调用 " << batched.calls / FRAMES << " 次/帧, " << ms(t1, t2) / FRAMES << " ms/帧, "
+         << after.batches / FRAMES << " 批" << endl;
+
+    destroyShapes(shapes);
+}
+
+void runBenchmarks() {
+    const int ROUNDS = 50;
+    const int COUNT = 20000;
+    vector<Point> shape;
+    for (int i = 0; i < 6; ++i) {
+        double angle_rad = MY_PI / 180.0 * (60 * i);
+        shape.push_back(Point(100 + 50 * cos(angle_rad), 100 + 50 * sin(angle_rad)));
+    }
+
+    cout << "[顶点缓冲区] " << ROUNDS << " 轮 x " << COUNT << " 个正六边形" << endl;
+    double checksum = 0;
+    double stdMs = runPolygonChurn<allocator<Point>>(ROUNDS, COUNT, shape, checksum);
+    PoolStats before = AlignedPool::instance().stats();
+    double poolMs = runPolygonChurn<AlignedAllocator<Point>>(ROUNDS, COUNT, shape, checksum);
+    PoolStats after = AlignedPool::instance().stats();
+
+    cout << "默认分配器: " << stdMs << " ms, 每个多边形一次 new" << endl;
+    cout << "内存池:     " << poolMs << " ms, 请求 " << after.requests - before.requests
+         << " 次, 系统分配 " << after.systemAllocs - before.systemAllocs << " 次, 归还系统 "
+         << after.systemFrees - before.systemFrees << " 次, 缓存 " << after.cachedBytes / 1024 << " KB" << endl;
+    cout << "校验和: " << checksum << endl;
+
+    benchRenderQueue();
+    benchAnimation();
+}
+
+//==============================================================================
+// 10. 主函数 main
 //==============================================================================
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        runBenchmarks();
+        TRACE_REPORT();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--animate") {
+        int status = runAnimationDemo(argc, argv, "实验二: 学号: 24061824 姓名: 盛智超", EGERGB(20, 20, 40));
+        TRACE_REPORT();
+        return status;
+    }
+
     initgraph(WINDOW_WIDTH, WINDOW_HEIGHT);
     setcaption("实验二: 学号: 24061824 姓名: 盛智超");
     setbkcolor(EGERGB(20, 20, 40)); // 深蓝色背景
+    EgeBackend screen;
+    RenderQueue queue;  // 原图画在第 0 层，变换后的图形画在第 1 层
 
     // --- 1. 原始图形 ---
     {
@@ -326,11 +663,15 @@ int main() {
 
         cleardevice();
         drawTitle("1: 原始图形", 20);
-        int textY = 50;
-        for (const auto& shape : shapes) {
-            drawText(20, textY, shape->getInfo(), LIGHTCYAN);
-            textY += 25;
-            shape->draw(WHITE); // 原图统一白色
+        {
+            TRACE_SPAN("1: 原始图形");
+            int textY = 50;
+            for (const auto& shape : shapes) {
+                drawText(20, textY, shape->getInfo(), LIGHTCYAN);
+                textY += 25;
+                shape->draw(queue, WHITE); // 原图统一白色
+            }
+            presentFrame(queue, screen);
         }
         drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
         getch();
@@ -345,13 +686,19 @@ int main() {
 
         cleardevice();
         drawTitle("2: 移动操作 (dx=50, dy=50)", 20);
-        for (size_t i = 0; i < originalShapes.size(); ++i) {
-            originalShapes[i]->draw(WHITE); // 原图：白色
-            movedShapes[i]->move(50, 50);
-            movedShapes[i]->draw(RED);      // 变换图：红色
+        {
+            TRACE_SPAN("2: 移动操作 (dx=50, dy=50)");
+            for (size_t i = 0; i < originalShapes.size(); ++i) {
+                queue.setLayer(0);
+                originalShapes[i]->draw(queue, WHITE); // 原图：白色
+                movedShapes[i]->move(50, 50);
+                queue.setLayer(1);
+                movedShapes[i]->draw(queue, RED);      // 变换图：红色
+            }
+            drawText(800, 20, "白: 原图", WHITE);
+            drawText(800, 50, "红: 移动后", RED);
+            presentFrame(queue, screen);
         }
-        drawText(800, 20, "白: 原图", WHITE);
-        drawText(800, 50, "红: 移动后", RED);
         drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
         getch();
 
@@ -366,13 +713,19 @@ int main() {
 
         cleardevice();
         drawTitle("3: 旋转操作 (45度)", 20);
-        for (size_t i = 0; i < originalShapes.size(); ++i) {
-            originalShapes[i]->draw(WHITE); // 原图：白色
-            rotatedShapes[i]->rotate(45);
-            rotatedShapes[i]->draw(RED);     // 变换图：红色
+        {
+            TRACE_SPAN("3: 旋转操作 (45度)");
+            for (size_t i = 0; i < originalShapes.size(); ++i) {
+                queue.setLayer(0);
+                originalShapes[i]->draw(queue, WHITE); // 原图：白色
+                rotatedShapes[i]->rotate(45);
+                queue.setLayer(1);
+                rotatedShapes[i]->draw(queue, RED);     // 变换图：红色
+            }
+            drawText(800, 20, "白: 原图", WHITE);
+            drawText(800, 50, "红: 旋转后", RED);
+            presentFrame(queue, screen);
         }
-        drawText(800, 20, "白: 原图", WHITE);
-        drawText(800, 50, "红: 旋转后", RED);
         drawText(20, WINDOW_HEIGHT - 40, "按任意键继续...", YELLOW);
         getch();
 
@@ -387,13 +740,19 @@ int main() {
 
         cleardevice();
         drawTitle("4: 缩放操作 (0.8倍)", 20);
-        for (size_t i = 0; i < originalShapes.size(); ++i) {
-            originalShapes[i]->draw(WHITE); // 原图：白色
-            scaledShapes[i]->scale(0.8);
-            scaledShapes[i]->draw(RED);      // 变换图：红色
+        {
+            TRACE_SPAN("4: 缩放操作 (0.8倍)");
+            for (size_t i = 0; i < originalShapes.size(); ++i) {
+                queue.setLayer(0);
+                originalShapes[i]->draw(queue, WHITE); // 原图：白色
+                scaledShapes[i]->scale(0.8);
+                queue.setLayer(1);
+                scaledShapes[i]->draw(queue, RED);      // 变换图：红色
+            }
+            drawText(800, 20, "白: 原图", WHITE);
+            drawText(800, 50, "红: 缩放后", RED);
+            presentFrame(queue, screen);
         }
-        drawText(800, 20, "白: 原图", WHITE);
-        drawText(800, 50, "红: 缩放后", RED);
         drawText(20, WINDOW_HEIGHT - 40, "按任意键退出...", YELLOW);
         getch();
 
@@ -402,5 +761,6 @@ int main() {
     }
 
     closegraph();
+    TRACE_REPORT();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*
+ * 绘制命令队列与渲染后端，实验一（Project1）与实验二（Project_11_13）共用
+ * draw() 只记录命令，一帧结束时按绘制状态排序、合并后统一提交给后端
+ */
+
+#pragma once
+
+#include <graphics.h>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+enum class DrawOp : unsigned char { Line, Circle, FillEllipse, Rectangle };
+
+// 一条绘制命令（24 字节）。Line/Rectangle 为两个端点；Circle 为圆心与 (半径, 0)；
+// FillEllipse 为 fillellipse 的四个参数
+struct DrawCommand {
+    int x0, y0, x1, y1;
+    color_t color;
+    unsigned short layer;   // 层与层之间保持记录顺序，只在层内按状态重排
+    unsigned char width;
+    DrawOp op;
+};
+
+struct RenderStats {
+    size_t primitives = 0;
+    size_t stateChanges = 0;  // setcolor / setfillcolor / setlinewidth 的调用次数
+    size_t batches = 0;       // 提交时状态不变的连续命令段数
+};
+
+// 绘制后端：EGE 窗口，或无窗口时只计数的空后端
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+    virtual void setColor(color_t color) = 0;
+    virtual void setFillColor(color_t color) = 0;
+    virtual void setLineWidth(int width) = 0;
+    virtual void submit(const DrawCommand& cmd) = 0;
+};
+
+class EgeBackend : public RenderBackend {
+public:
+    void setColor(color_t color) override { setcolor(color); }
+    void setFillColor(color_t color) override { setfillcolor(color); }
+    void setLineWidth(int width) override { setlinewidth(width); }
+
+    void submit(const DrawCommand& cmd) override {
+        switch (cmd.op) {
+        case DrawOp::Line: line(cmd.x0, cmd.y0, cmd.x1, cmd.y1); break;
+        case DrawOp::Circle: circle(cmd.x0, cmd.y0, cmd.x1); break;
+        case DrawOp::FillEllipse: fillellipse(cmd.x0, cmd.y0, cmd.x1, cmd.y1); break;
+        case DrawOp::Rectangle: rectangle(cmd.x0, cmd.y0, cmd.x1, cmd.y1); break;
+        }
+    }
+};
+
+class CountingBackend : public RenderBackend {
+public:
+    size_t calls = 0;
+    long long checksum = 0;   // 防止提交过程被编译器整体优化掉
+
+    void setColor(color_t color) override { calls++; checksum += color; }
+    void setFillColor(color_t color) override { calls++; checksum += color; }
+    void setLineWidth(int width) override { calls++; checksum += width; }
+    void submit(const DrawCommand& cmd) override { calls++; checksum += cmd.x0 + cmd.y1; }
+};
+
+class RenderQueue {
+private:
+    vector<DrawCommand> commands;
+    vector<DrawCommand> sorted;     // 分桶时的目标缓冲区，与 commands 交替使用
+    vector<unsigned> bucketOf;
+    unsigned short layer = 0;
+
+    struct StateKey {
+        unsigned short layer;
+        color_t color;
+        unsigned char width;
+
+        bool operator<(const StateKey& o) const {
+            if (layer != o.layer) return layer < o.layer;
+            if (color != o.color) return color < o.color;
+            return width < o.width;
+        }
+        bool matches(const DrawCommand& c) const { return layer == c.layer && color == c.color && width == c.width; }
+    };
+
+    void record(DrawOp op, int x0, int y0, int x1, int y1, color_t color, int width) {
+        commands.push_back({ x0, y0, x1, y1, color, layer, (unsigned char)width, op });
+    }
+
+    // 按 (层, 颜色, 线宽) 分桶后稳定地计数排序：一帧里的状态组合通常只有几种，线性查找即可，
+    // 总代价 O(命令数)；组合过多时退回比较排序
+    void sortByState() {
+        const size_t MAX_BUCKETS = 64;
+        vector<StateKey> keys;
+        bucketOf.resize(commands.size());
+        unsigned last = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+            const DrawCommand& c = commands[i];
+            if (keys.empty() || !keys[last].matches(c)) {
+                last = 0;
+                while (last < keys.size() && !keys[last].matches(c)) last++;
+                if (last == keys.size()) {
+                    if (keys.size() == MAX_BUCKETS) {
+                        stable_sort(commands.begin(), commands.end(), [](const DrawCommand& a, const DrawCommand& b) {
+                            return StateKey{ a.layer, a.color, a.width } < StateKey{ b.layer, b.color, b.width };
+                        });
+                        return;
+                    }
+                    keys.push_back({ c.layer, c.color, c.width });
+                }
+            }
+            bucketOf[i] = last;
+        }
+
+        vector<unsigned> order(keys.size()), start(keys.size() + 1, 0);
+        for (unsigned k = 0; k < keys.size(); k++) order[k] = k;
+        sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return keys[a] < keys[b]; });
+        vector<unsigned> rank(keys.size());
+        for (unsigned r = 0; r < order.size(); r++) rank[order[r]] = r;
+        for (unsigned& id : bucketOf) {
+            id = rank[id];
+            start[id + 1]++;
+        }
+        for (size_t k = 0; k < keys.size(); k++) start[k + 1] += start[k];
+        sorted.resize(commands.size());
+        for (size_t i = 0; i < commands.size(); i++) sorted[start[bucketOf[i]]++] = commands[i];
+        commands.swap(sorted);
+    }
+
+public:
+    // 之后记录的命令所在的层：层号大的画在上面，flush 后回到第 0 层
+    void setLayer(unsigned short l) { layer = l; }
+
+    void addLine(int x0, int y0, int x1, int y1, color_t color, int width) { record(DrawOp::Line, x0, y0, x1, y1, color, width); }
+    void addCircle(int x, int y, int r, color_t color, int width) { record(DrawOp::Circle, x, y, r, 0, color, width); }
+    void addFillEllipse(int x, int y, int rx, int ry, color_t color, int width) { record(DrawOp::FillEllipse, x, y, rx, ry, color, width); }
+    void addRectangle(int x0, int y0, int x1, int y1, color_t color, int width) { record(DrawOp::Rectangle, x0, y0, x1, y1, color, width); }
+
+    size_t size() const { return commands.size(); }
+
+    // 提交并清空队列。byState 时先在每层内按 (颜色, 线宽) 稳定重排；
+    // 无论是否重排都只在状态确实改变时调用 set*，提交开始时认为后端状态未知
+    RenderStats flush(RenderBackend& backend, bool byState = true) {
+        if (byState) sortByState();
+
+        RenderStats stats;
+        bool known = false, fillKnown = false;
+        color_t color = 0, fill = 0;
+        int width = 0;
+        for (const DrawCommand& cmd : commands) {
+            bool changed = false;
+            if (!known || cmd.color != color) {
+                backend.setColor(cmd.color);
+                stats.stateChanges++;
+                changed = true;
+            }
+            if (!known || cmd.width != width) {
+                backend.setLineWidth(cmd.width);
+                stats.stateChanges++;
+                changed = true;
+            }
+            color = cmd.color;
+            width = cmd.width;
+            known = true;
+            if (cmd.op == DrawOp::FillEllipse && (!fillKnown || fill != cmd.color)) {
+                backend.setFillColor(cmd.color);
+                stats.stateChanges++;
+                fill = cmd.color;
+                fillKnown = true;
+                changed = true;
+            }
+            if (changed || stats.batches == 0) stats.batches++;
+            backend.submit(cmd);
+            stats.primitives++;
+        }
+        commands.clear();
+        layer = 0;
+        return stats;
+    }
+};
@@ -0,0 +1,296 @@
+/*
+ * 连续动画与帧时间统计，实验一（Project1）与实验二（Project_11_13）共用
+ * 固定步长更新姿态，按插值姿态绘制，逐帧统计更新与绘制耗时
+ * 用到包含方定义的 Shape、WINDOW_WIDTH/WINDOW_HEIGHT、drawText 以及 render_queue.h、shape_trace.h，
+ * 因此要在这些定义之后包含；populateScene 由各项目用自己的图形类实现
+ */
+
+#pragma once
+
+#include <graphics.h>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// 图形在动画中的姿态：中心位置、累计旋转角度（度）、相对初始大小的缩放倍数
+struct Pose {
+    double x, y, angle, scale;
+};
+
+// 每个图形的运动参数：速度（像素/秒）、角速度（度/秒）、缩放脉动的角频率（弧度/秒）与初相
+struct Motion {
+    double vx, vy, spin, pulse, phase;
+};
+
+const double ANIMATION_STEP = 1.0 / 100;       // 固定更新步长（秒），与显示帧率无关
+const double MAX_FRAME_TIME = 0.25;            // 单帧最多追赶的时间，卡顿后不会越追越慢
+const double HEADLESS_FRAME = 1.0 / 60;        // 无窗口运行时每帧推进的模拟时间
+const double FRAME_BUDGET_MS = 1000.0 / 60;    // 60 帧/秒的单帧预算
+
+// 动画场景：step() 只推进姿态数组；render() 按插值姿态对图形做增量 scale/rotate/move，再记录绘制命令
+// 旋转、缩放都绕图形自身中心进行，只要图形中心与姿态位置一致，增量变换就与从初始状态一次变换到位等价
+class AnimationScene {
+private:
+    vector<Shape*> shapes;
+    vector<color_t> colors;
+    vector<Motion> motions;
+    vector<Pose> previous, current, shown;  // 上一步、当前步、图形对象实际所处的姿态
+    double time = 0;
+
+public:
+    AnimationScene() = default;
+    AnimationScene(const AnimationScene&) = delete;
+    AnimationScene& operator=(const AnimationScene&) = delete;
+    ~AnimationScene() {
+        for (auto shape : shapes) {
+            delete shape;
+        }
+    }
+
+    // 接管 shape 的所有权；shape 的中心应位于 (x, y)
+    void add(Shape* shape, double x, double y, const Motion& motion, color_t color) {
+        Pose pose = { x, y, 0, 1 };
+        shapes.push_back(shape);
+        colors.push_back(color);
+        motions.push_back(motion);
+        previous.push_back(pose);
+        current.push_back(pose);
+        shown.push_back(pose);
+    }
+
+    size_t size() const { return shapes.size(); }
+
+    // 推进 dt 秒：匀速移动并在窗口边缘反弹，匀速旋转，缩放在 0.7 ~ 1.3 倍之间脉动
+    void step(double dt) {
+        time += dt;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            Motion& m = motions[i];
+            Pose p = current[i];
+            previous[i] = p;
+            p.x += m.vx * dt;
+            p.y += m.vy * dt;
+            if ((p.x < 0 && m.vx < 0) || (p.x > WINDOW_WIDTH && m.vx > 0)) m.vx = -m.vx;
+            if ((p.y < 0 && m.vy < 0) || (p.y > WINDOW_HEIGHT && m.vy > 0)) m.vy = -m.vy;
+            p.angle += m.spin * dt;
+            p.scale = 1 + 0.3 * sin(m.pulse * time + m.phase);
+            current[i] = p;
+        }
+    }
+
+    // alpha 为上一步到当前步之间的比例（0 ~ 1），图形按插值后的姿态绘制
+    void render(RenderQueue& queue, double alpha) {
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const Pose& a = previous[i];
+            const Pose& b = current[i];
+            Pose target = { a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha,
+                            a.angle + (b.angle - a.angle) * alpha, a.scale + (b.scale - a.scale) * alpha };
+            Pose& s = shown[i];
+            shapes[i]->scale(target.scale / s.scale);
+            shapes[i]->rotate(target.angle - s.angle);
+            shapes[i]->move(target.x - s.x, target.y - s.y);
+            s = target;
+            shapes[i]->draw(queue, colors[i]);
+        }
+    }
+};
+
+// 一段帧时间的统计，耗时均为毫秒；帧时间 = 更新 + 绘制，不含等待垂直同步的时间
+struct FrameSummary {
+    size_t frames;
+    double mean, p99, max;
+    double update, draw;
+    double stepsPerFrame;
+};
+
+// 逐帧记录更新、绘制耗时与本帧执行的更新步数
+class FrameStats {
+private:
+    vector<double> updateMs, drawMs;
+    vector<int> steps;
+
+public:
+    void record(double update, double draw, int stepCount) {
+        updateMs.push_back(update);
+        drawMs.push_back(draw);
+        steps.push_back(stepCount);
+    }
+
+    size_t size() const { return steps.size(); }
+
+    // 统计最近 window 帧，window 为 0 时统计全部
+    FrameSummary summarize(size_t window = 0) const {
+        size_t n = steps.size();
+        size_t first = (window > 0 && window < n) ? n - window : 0;
+        FrameSummary s = { n - first, 0, 0, 0, 0, 0, 0 };
+        if (s.frames == 0) return s;
+
+        vector<double> total;
+        total.reserve(s.frames);
+        for (size_t k = first; k < n; k++) {
+            double t = updateMs[k] + drawMs[k];
+            total.push_back(t);
+            s.mean += t;
+            s.max = max(s.max, t);
+            s.update += updateMs[k];
+            s.draw += drawMs[k];
+            s.stepsPerFrame += steps[k];
+        }
+        s.mean /= s.frames;
+        s.update /= s.frames;
+        s.draw /= s.frames;
+        s.stepsPerFrame /= s.frames;
+        size_t rank = (size_t)ceil(0.99 * s.frames) - 1;
+        nth_element(total.begin(), total.begin() + rank, total.end());
+        s.p99 = total[rank];
+        return s;
+    }
+
+    // 每帧一行写成 CSV，文件无法打开时返回 false
+    bool exportCsv(const string& path) const {
+        ofstream out(path);
+        if (!out) return false;
+        out << "frame,steps,update_ms,draw_ms,frame_ms\n";
+        for (size_t k = 0; k < steps.size(); k++) {
+            out << k << ',' << steps[k] << ',' << updateMs[k] << ',' << drawMs[k] << ','
+                << updateMs[k] + drawMs[k] << '\n';
+        }
+        return (bool)out;
+    }
+};
+
+string formatSummary(const FrameSummary& s) {
+    ostringstream oss;
+    oss << fixed << setprecision(2) << "帧时间 平均 " << s.mean << " ms, p99 " << s.p99 << " ms, 最大 " << s.max
+        << " ms | 更新 " << s.update << " ms + 绘制 " << s.draw << " ms | 每帧 " << s.stepsPerFrame << " 步";
+    return oss.str();
+}
+
+// 固定步长主循环：每帧按经过的时间补足若干次 step()，剩余不足一步的时间作为插值比例绘制
+// frames 为 0 时一直运行到按键或关闭窗口；headless 时不碰窗口、不等待，每帧推进 HEADLESS_FRAME 的模拟时间，
+// 测到的就是更新与绘制本身的耗时
+void runAnimation(AnimationScene& scene, RenderQueue& queue, RenderBackend& backend, FrameStats& stats,
+                  int frames, bool headless) {
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    double accumulator = 0;
+    auto last = chrono::steady_clock::now();
+    for (int f = 0; frames <= 0 || f < frames; f++) {
+        TRACE_SPAN("动画帧");
+        auto start = chrono::steady_clock::now();
+        double elapsed = headless ? HEADLESS_FRAME : chrono::duration<double>(start - last).count();
+        last = start;
+        accumulator += min(elapsed, MAX_FRAME_TIME);
+        int steps = 0;
+        while (accumulator >= ANIMATION_STEP) {
+            scene.step(ANIMATION_STEP);
+            accumulator -= ANIMATION_STEP;
+            steps++;
+        }
+        auto updated = chrono::steady_clock::now();
+
+        if (!headless) cleardevice();
+        scene.render(queue, accumulator / ANIMATION_STEP);
+        RenderStats rendered = queue.flush(backend);
+        auto drawn = chrono::steady_clock::now();
+        stats.record(ms(start, updated), ms(updated, drawn), steps);
+
+        if (!headless) {
+            drawText(20, 20, formatSummary(stats.summarize(120)), LIGHTGREEN);
+            ostringstream oss;
+            oss << "图形 " << scene.size() << " 个, 绘制命令 " << rendered.primitives << " 条 | 按任意键结束";
+            drawText(20, 45, oss.str(), YELLOW);
+            delay_fps(60);
+            if (!is_run()) break;
+            if (kbhit()) {
+                getch();
+                break;
+            }
+        }
+    }
+}
+
+// 随机摆放 count 个图形，每个图形的中心即姿态位置；seed 相同时场景相同，便于对比（由各项目实现）
+void populateScene(AnimationScene& scene, int count, unsigned seed);
+
+// main --animate [图形数] [帧数] [--headless]
+// 帧数为 0 时运行到按键为止（无窗口时默认 600 帧）；结束后把每帧耗时写入 frame_stats.csv；caption、background 为窗口标题与背景色
+int runAnimationDemo(int argc, char* argv[], const char* caption, color_t background) {
+    int count = 500, frames = 0;
+    bool headless = false;
+    int positional = 0;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (positional++ == 0) {
+            count = max(1, atoi(arg.c_str()));
+        } else {
+            frames = max(0, atoi(arg.c_str()));
+        }
+    }
+    if (headless && frames == 0) frames = 600;
+
+    AnimationScene scene;
+    populateScene(scene, count, 2024);
+    RenderQueue queue;
+    FrameStats stats;
+    if (headless) {
+        CountingBackend backend;
+        runAnimation(scene, queue, backend, stats, frames, true);
+    } else {
+        initgraph(WINDOW_WIDTH, WINDOW_HEIGHT);
+        setcaption(caption);
+        setbkcolor(background);
+        setrendermode(RENDER_MANUAL);  // 手动刷新：每帧画完后由 delay_fps() 一次性显示，避免闪烁
+        EgeBackend screen;
+        runAnimation(scene, queue, screen, stats, frames, false);
+        closegraph();
+    }
+
+    cout << count << " 个图形, " << stats.size() << " 帧: " << formatSummary(stats.summarize()) << endl;
+    if (!stats.exportCsv("frame_stats.csv")) {
+        cerr << "无法写入 frame_stats.csv" << endl;
+        return 1;
+    }
+    cout << "每帧耗时已写入 frame_stats.csv" << endl;
+    return 0;
+}
+
+// 性能测试（main --bench）：无窗口跑动画主循环，看 p99 帧时间不超过 16.7 ms 时最多能放多少个图形
+// 绘制只到计数后端为止，不含真实光栅化，结果是上限；逐个规模的统计写入 animation_budget.csv
+void benchAnimation() {
+    TRACE_SPAN("benchAnimation");
+    const int FRAMES = 240;
+    const int COUNTS[] = { 1000, 4000, 16000, 64000 };
+    cout << "[动画主循环] 固定步长 " << ANIMATION_STEP * 1000 << " ms, 每帧模拟 " << HEADLESS_FRAME * 1000
+         << " ms, " << FRAMES << " 帧" << endl;
+
+    ofstream csv("animation_budget.csv");
+    csv << "shapes,frames,mean_ms,p99_ms,max_ms,update_ms,draw_ms,steps_per_frame\n";
+    int fits = 0;
+    for (int count : COUNTS) {
+        AnimationScene scene;
+        populateScene(scene, count, 2024);
+        RenderQueue queue;
+        CountingBackend backend;
+        FrameStats stats;
+        runAnimation(scene, queue, backend, stats, FRAMES, true);
+        FrameSummary s = stats.summarize();
+        cout << count << " 个图形: " << formatSummary(s) << endl;
+        csv << count << ',' << s.frames << ',' << s.mean << ',' << s.p99 << ',' << s.max << ','
+            << s.update << ',' << s.draw << ',' << s.stepsPerFrame << '\n';
+        if (s.p99 <= FRAME_BUDGET_MS) fits = count;
+    }
+    cout << "p99 帧时间在 " << FRAME_BUDGET_MS << " ms 以内的最大规模: " << fits << " 个图形"
+         << (csv ? "（明细见 animation_budget.csv）" : "") << endl;
+}
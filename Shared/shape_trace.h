@@ -0,0 +1,249 @@
+/*
+ * 调用追踪，实验一（Project1）与实验二（Project_11_13）共用
+ * 统计各图形类型每个虚函数的调用次数与耗时，记录演示各阶段的耗时
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+
+using namespace std;
+
+// 编译时定义 SHAPE_TRACE 才启用；未定义时下面的宏全部展开为空，不产生任何代码
+//   TRACE_TYPE(Circle)  写在图形类里，给出追踪时显示的类型名
+//   TRACE_CALL(Draw)    写在虚函数开头，按 类型 x 方法 统计调用次数与耗时分布
+//   TRACE_SPAN("名称")  记录所在作用域的耗时，用于标出演示的各个阶段
+//   TRACE_REPORT()      程序结束前调用：写出 Chrome trace 文件 shape_trace.json，并打印汇总表
+// 每个线程写自己的缓冲区，只在线程第一次记录时加锁登记
+#ifdef SHAPE_TRACE
+
+enum class TraceMethod { Draw, Rotate, Scale, Move, Mirror, GetArea, GetInfo, Span };
+
+const char* const TRACE_METHOD_NAMES[] = { "draw", "rotate", "scale", "move", "mirror", "getArea", "getInfo", "span" };
+
+struct TraceEvent {
+    const char* name;          // 图形类型名或阶段名，必须是字符串常量
+    TraceMethod method;
+    long long start, duration; // 纳秒，start 从追踪开始时计
+};
+
+// 一种 (名称, 方法) 的累计数据；histogram[b] 为耗时落在 [2^b, 2^(b+1)) 纳秒的次数
+struct TraceStats {
+    const char* name;
+    TraceMethod method;
+    unsigned long long calls, totalNs, maxNs;
+    unsigned long long histogram[40];
+};
+
+class TraceBuffer {
+public:
+    static const size_t MAX_EVENTS = 1 << 20;  // 超出后虚函数调用只计数、不再保存事件（阶段总是保存），避免占满内存
+
+    int tid;
+    vector<TraceEvent> events;
+    size_t dropped = 0;
+    vector<TraceStats> stats;
+
+    explicit TraceBuffer(int tid) : tid(tid) {}
+
+    void record(const char* name, TraceMethod method, long long start, long long duration) {
+        if (events.size() < MAX_EVENTS || method == TraceMethod::Span) {
+            events.push_back({ name, method, start, duration });
+        } else {
+            dropped++;
+        }
+        TraceStats& s = find(name, method);
+        unsigned long long ns = (unsigned long long)max(0LL, duration);
+        int bucket = 0;
+        while (bucket < 39 && (ns >> (bucket + 1)) != 0) bucket++;
+        s.calls++;
+        s.totalNs += ns;
+        s.maxNs = max(s.maxNs, ns);
+        s.histogram[bucket]++;
+    }
+
+private:
+    size_t last = 0;  // 同一类型、方法往往连续出现，先查上次命中的位置
+
+    TraceStats& find(const char* name, TraceMethod method) {
+        if (last < stats.size() && stats[last].name == name && stats[last].method == method) return stats[last];
+        for (size_t i = 0; i < stats.size(); i++) {
+            if (stats[i].name == name && stats[i].method == method) {
+                last = i;
+                return stats[i];
+            }
+        }
+        TraceStats s = {};
+        s.name = name;
+        s.method = method;
+        stats.push_back(s);
+        last = stats.size() - 1;
+        return stats[last];
+    }
+};
+
+class Tracer {
+private:
+    mutex lock;
+    vector<unique_ptr<TraceBuffer>> buffers;  // 线程结束后缓冲区仍保留到报告时
+    chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+
+    static string jsonEscape(const char* s) {
+        string out;
+        for (; *s; s++) {
+            if (*s == '"' || *s == '\\') out += '\\';
+            out += *s;
+        }
+        return out;
+    }
+
+    // 名称按显示宽度补齐到 width 列：非 ASCII 字符（这里都是汉字）按 2 列算
+    static string padName(const char* s, int width) {
+        string out = s;
+        int columns = 0;
+        for (; *s; s++) {
+            unsigned char c = (unsigned char)*s;
+            if (c < 0x80) columns++;
+            else if (c >= 0xC0) columns += 2;
+        }
+        if (columns < width) out.append(width - columns, ' ');
+        return out;
+    }
+
+    // 直方图第一个累计次数达到 fraction 的格子的上界
+    static unsigned long long percentile(const TraceStats& s, double fraction) {
+        unsigned long long target = (unsigned long long)ceil(fraction * s.calls), seen = 0;
+        for (int b = 0; b < 40; b++) {
+            seen += s.histogram[b];
+            if (seen >= target) return min(s.maxNs, (2ULL << b) - 1);
+        }
+        return s.maxNs;
+    }
+
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    long long now() const {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+    }
+
+    TraceBuffer& local() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (!buffer) {
+            lock_guard<mutex> guard(lock);
+            buffers.emplace_back(new TraceBuffer((int)buffers.size() + 1));
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    // Chrome trace-event JSON（chrome://tracing 或 Perfetto 打开），每次调用是一个完整事件（ph = "X"）
+    // 应在其他线程都结束后调用
+    bool writeChromeTrace(const string& path) {
+        lock_guard<mutex> guard(lock);
+        ofstream out(path);
+        if (!out) return false;
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        out << fixed << setprecision(3);
+        for (const auto& buffer : buffers) {
+            for (const TraceEvent& e : buffer->events) {
+                out << (first ? "\n" : ",\n") << "{\"name\":\"" << jsonEscape(e.name);
+                if (e.method != TraceMethod::Span) out << "::" << TRACE_METHOD_NAMES[(int)e.method];
+                out << "\",\"cat\":\"" << TRACE_METHOD_NAMES[(int)e.method] << "\",\"ph\":\"X\",\"ts\":" << e.start / 1000.0
+                    << ",\"dur\":" << e.duration / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return (bool)out;
+    }
+
+    // 合并所有线程的统计，按总耗时从高到低打印；分位数取直方图格子的上界
+    void printSummary(ostream& os) {
+        lock_guard<mutex> guard(lock);
+        vector<TraceStats> merged;
+        size_t dropped = 0;
+        for (const auto& buffer : buffers) {
+            dropped += buffer->dropped;
+            for (const TraceStats& s : buffer->stats) {
+                auto it = find_if(merged.begin(), merged.end(), [&](const TraceStats& m) {
+                    return m.name == s.name && m.method == s.method;
+                });
+                if (it == merged.end()) {
+                    merged.push_back(s);
+                    continue;
+                }
+                it->calls += s.calls;
+                it->totalNs += s.totalNs;
+                it->maxNs = max(it->maxNs, s.maxNs);
+                for (int b = 0; b < 40; b++) it->histogram[b] += s.histogram[b];
+            }
+        }
+        sort(merged.begin(), merged.end(), [](const TraceStats& a, const TraceStats& b) { return a.totalNs > b.totalNs; });
+
+        os << padName("name", 28) << left << setw(10) << "method" << right << setw(12) << "calls" << setw(14) << "total ms"
+           << setw(14) << "mean ns" << setw(14) << "p50 ns" << setw(14) << "p99 ns" << setw(14) << "max ns" << endl;
+        for (const TraceStats& s : merged) {
+            os << padName(s.name, 28) << left << setw(10) << TRACE_METHOD_NAMES[(int)s.method] << right
+               << setw(12) << s.calls << setw(14) << fixed << setprecision(2) << s.totalNs / 1e6
+               << setw(14) << setprecision(0) << (double)s.totalNs / s.calls
+               << setw(14) << percentile(s, 0.5) << setw(14) << percentile(s, 0.99) << setw(14) << s.maxNs << endl;
+        }
+        os.unsetf(ios::floatfield);
+        os << setprecision(6);
+        os << "线程数 " << buffers.size() << ", 超出缓冲区未写入 trace 的事件 " << dropped << " 个" << endl;
+    }
+
+    void report(const string& path) {
+        printSummary(cout);
+        if (writeChromeTrace(path)) {
+            cout << "调用追踪已写入 " << path << endl;
+        } else {
+            cerr << "无法写入 " << path << endl;
+        }
+    }
+};
+
+class TraceScope {
+private:
+    const char* name;
+    TraceMethod method;
+    long long start;
+
+public:
+    TraceScope(const char* name, TraceMethod method)
+        : name(name), method(method), start(Tracer::instance().now()) {}
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    ~TraceScope() {
+        Tracer& tracer = Tracer::instance();
+        long long end = tracer.now();
+        tracer.local().record(name, method, start, end - start);
+    }
+};
+
+#define TRACE_TYPE(type) const char* traceName() const override { return #type; }
+#define TRACE_CALL(method) TraceScope traceCall_(this->traceName(), TraceMethod::method)
+#define TRACE_SPAN(name) TraceScope traceSpan_(name, TraceMethod::Span)
+#define TRACE_REPORT() Tracer::instance().report("shape_trace.json")
+
+#else
+
+#define TRACE_TYPE(type)
+#define TRACE_CALL(method) ((void)0)
+#define TRACE_SPAN(name) ((void)0)
+#define TRACE_REPORT() ((void)0)
+
+#endif
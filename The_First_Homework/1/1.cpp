@@ -1,31 +1,410 @@
-#include<iostream> 
+#include<iostream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<chrono>
+#include<cstdint>
+#include<cstring>
 
 using namespace std;
 
+// 运行 main --bench 执行性能测试
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TIME_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
 
+
+
+// 一天之内的时刻，内部只存自零点起的秒数（0 ~ 86399）
+// 构造与加减运算都按 24 小时取模归一化，如 23:59:50 + 20 秒 = 00:00:10
 class Time
 {
 public:
+   static const int SECONDS_PER_DAY = 86400;
+   static const uint32_t INVALID = 0xFFFFFFFFu;  // 批量解析时表示格式或范围无效的记录
+
+   Time(int hour = 0, int minute = 0, int sec = 0);
+   static Time from_seconds(long long seconds);
+
    void set_time(void);
    void show_time(void);
 
+   int get_hour() const { return secs / 3600; }
+   int get_minute() const { return secs / 60 % 60; }
+   int get_sec() const { return secs % 60; }
+   int seconds() const { return secs; }
+
+   Time operator+(long long seconds) const { return from_seconds((long long)secs + seconds); }
+   Time operator-(long long seconds) const { return from_seconds((long long)secs - seconds); }
+   Time& operator+=(long long seconds) { return *this = *this + seconds; }
+   Time& operator-=(long long seconds) { return *this = *this - seconds; }
+
+   // 两个时刻相差的秒数（同一天内，可为负）
+   int operator-(const Time& other) const { return secs - other.secs; }
+
+   bool operator==(const Time& other) const { return secs == other.secs; }
+   bool operator!=(const Time& other) const { return secs != other.secs; }
+   bool operator<(const Time& other) const { return secs < other.secs; }
+   bool operator<=(const Time& other) const { return secs <= other.secs; }
+   bool operator>(const Time& other) const { return secs > other.secs; }
+   bool operator>=(const Time& other) const { return secs >= other.secs; }
+
+   // 写出 "HH:MM:SS"（8 个字符，不含结尾符）
+   char* format(char* out) const;
+
 private:
-   int hour;
-   int minute;
-   int sec;
+   int32_t secs;
+
+   static int32_t normalize(long long seconds);
 };
 
 
 
-Time t; 
+int32_t Time::normalize(long long seconds)
+
+{
+
+ long long s = seconds % SECONDS_PER_DAY;
+
+ return (int32_t)(s < 0 ? s + SECONDS_PER_DAY : s);
+
+}
+
+
+
+Time::Time(int hour, int minute, int sec)
+
+{
+
+ secs = normalize((long long)hour * 3600 + (long long)minute * 60 + sec);
+
+}
+
+
+
+Time Time::from_seconds(long long seconds)
+
+{
+
+ Time t;
+
+ t.secs = normalize(seconds);
+
+ return t;
+
+}
+
+
+
+// 两位数字表 "00" ~ "59"，格式化时按下标直接拷贝
+static const char TWO_DIGITS[] =
+   "00010203040506070809101112131415161718192021222324252627282930"
+   "313233343536373839404142434445464748495051525354555657585960";
+
+
+
+// 先在局部缓冲区拼好 8 个字符再一次写出，编译器可合并为一次 8 字节存储
+inline void format_seconds(uint32_t s, char* out)
+
+{
+
+ uint32_t h = s / 3600, rem = s - h * 3600;
+
+ uint32_t m = rem / 60, sec = rem - m * 60;
+
+ char buf[8];
+
+ memcpy(buf, TWO_DIGITS + 2 * h, 2);
+
+ buf[2] = ':';
+
+ memcpy(buf + 3, TWO_DIGITS + 2 * m, 2);
+
+ buf[5] = ':';
+
+ memcpy(buf + 6, TWO_DIGITS + 2 * sec, 2);
+
+ memcpy(out, buf, 8);
+
+}
+
+
+
+char* Time::format(char* out) const
+
+{
+
+ format_seconds((uint32_t)secs, out);
+
+ return out + 8;
+
+}
+
 
 
+//==============================================================================
+// 批量解析与格式化：定长记录 "HH:MM:SS" 后跟一个分隔符（如换行），每条 stride 字节
+// 数字、冒号位置与范围（时 < 24、分 < 60、秒 < 60）在同一遍中检查，无效记录输出 INVALID
+//==============================================================================
 
-int main()
+// 单条记录的标量版本
+inline uint32_t parse_time_scalar(const char* p)
 
 {
 
+ unsigned d[8];
+
+ for (int i = 0; i < 8; i++) d[i] = (unsigned char)p[i] - '0';
+
+ bool ok = d[0] <= 9 && d[1] <= 9 && d[2] == 10 && d[3] <= 9 && d[4] <= 9
+        && d[5] == 10 && d[6] <= 9 && d[7] <= 9;
+
+ unsigned h = d[0] * 10 + d[1], m = d[3] * 10 + d[4], s = d[6] * 10 + d[7];
+
+ return ok && h < 24 && m < 60 && s < 60 ? h * 3600 + m * 60 + s : Time::INVALID;
+
+}
+
+
+
+size_t parse_times_scalar(const char* text, size_t count, size_t stride, uint32_t* out)
+
+{
+
+ size_t invalid = 0;
+
+ for (size_t i = 0; i < count; i++)
+ {
+   out[i] = parse_time_scalar(text + i * stride);
+   invalid += out[i] == Time::INVALID;
+ }
+
+ return invalid;
+
+}
+
+
+
+#ifdef TIME_X86_DISPATCH
+
+// AVX2 版本：每次取 4 条记录的前 8 字节拼成一个 256 位向量，每个 64 位通道处理一条
+// 减去 '0' 后数字应在 0~9、冒号应恰为 10；maddubs/madd 两次乘加得到各字段与总秒数
+__attribute__((target("avx2")))
+size_t parse_times_avx2(const char* text, size_t count, size_t stride, uint32_t* out)
+
+{
+
+ const __m256i zero = _mm256_set1_epi8('0');
+ const __m256i lower = _mm256_set1_epi64x(0x00000A00000A0000LL);  // 冒号位置下限 10，数字下限 0
+ const __m256i upper = _mm256_set1_epi64x(0x09090A09090A0909LL);  // 冒号位置上限 10，数字上限 9
+ // 字节对 (H1,H0) (:,M1) (M0,:) (S1,S0) 的权重 -> 16 位字 hh, 10*M1, M0, ss
+ const __m256i w8 = _mm256_set1_epi64x(0x010A00010A00010ALL);
+ // 16 位字对 (hh, 10*M1) (M0, ss) 的权重 -> 32 位 hh*3600 + 10*M1*60, M0*60 + ss
+ const __m256i w16 = _mm256_set1_epi64x(0x0001003C003C0E10LL);
+ const __m256i limits = _mm256_set1_epi64x(0x003C003C003C0018LL);  // 时 < 24，分 < 60，秒 < 60
+
+ size_t invalid = 0;
+
+ size_t i = 0;
+
+ for (; i + 4 <= count; i += 4)
+ {
+   const char* p = text + i * stride;
+   long long r0, r1, r2, r3;
+   memcpy(&r0, p, 8);
+   memcpy(&r1, p + stride, 8);
+   memcpy(&r2, p + 2 * stride, 8);
+   memcpy(&r3, p + 3 * stride, 8);
+
+   __m256i d = _mm256_sub_epi8(_mm256_set_epi64x(r3, r2, r1, r0), zero);
+
+   // 逐字节范围检查：lower <= d <= upper（无符号比较）
+   __m256i inRange = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(d, upper), d),
+                                      _mm256_cmpeq_epi8(_mm256_max_epu8(d, lower), d));
+
+   __m256i words = _mm256_maddubs_epi16(d, w8);          // hh, 10*M1, M0, ss
+   // 分钟合并到第 1 个字：10*M1 + M0，再与上限逐字比较
+   __m256i minutes = _mm256_add_epi16(words, _mm256_srli_epi64(words, 16));
+   __m256i fields = _mm256_blend_epi16(words, minutes, 0x22);   // hh, mm, *, ss
+   __m256i fieldsOk = _mm256_cmpgt_epi16(limits, fields);
+
+   __m256i pairs = _mm256_madd_epi16(words, w16);
+   __m256i total = _mm256_add_epi32(pairs, _mm256_srli_epi64(pairs, 32));
+
+   // 每条记录的 8 个字节都在范围内，且各字段都小于上限时，该记录的 8 位掩码全为 1
+   int byteMask = _mm256_movemask_epi8(_mm256_and_si256(inRange, fieldsOk));
+   alignas(32) uint32_t lanes[8];
+   _mm256_store_si256((__m256i*)lanes, total);
+
+   for (int k = 0; k < 4; k++)
+   {
+     bool ok = ((byteMask >> (8 * k)) & 0xFF) == 0xFF;
+     out[i + k] = ok ? lanes[2 * k] : Time::INVALID;
+     invalid += !ok;
+   }
+ }
+
+ return invalid + parse_times_scalar(text + i * stride, count - i, stride, out + i);
+
+}
+
+
+
+inline bool cpu_has_avx2()
+
+{
+
+ static const bool has = __builtin_cpu_supports("avx2");
+
+ return has;
+
+}
+
+#endif
+
+
+
+// 解析 count 条定长记录到 out，返回无效记录数；记录间隔 stride 字节（至少 8）
+size_t parse_times(const char* text, size_t count, size_t stride, uint32_t* out)
+
+{
+
+#ifdef TIME_X86_DISPATCH
+
+ if (cpu_has_avx2()) return parse_times_avx2(text, count, stride, out);
+
+#endif
+
+ return parse_times_scalar(text, count, stride, out);
+
+}
+
+
+
+// 把 count 个秒数（0 ~ 86399）格式化为 "HH:MM:SS" 加 separator，每条 9 字节；INVALID 输出 "--:--:--"
+char* format_times(const uint32_t* values, size_t count, char* out, char separator = '\n')
+
+{
+
+ for (size_t i = 0; i < count; i++)
+ {
+   if (values[i] == Time::INVALID) memcpy(out, "--:--:--", 8);
+   else format_seconds(values[i], out);
+   out[8] = separator;
+   out += 9;
+ }
+
+ return out;
+
+}
+
+
+
+//==============================================================================
+// 性能测试
+//==============================================================================
+
+double elapsed_ms(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b)
+
+{
+
+ return chrono::duration<double, milli>(b - a).count();
+
+}
+
+
+
+void run_benchmarks()
+
+{
+
+ const size_t COUNT = 20000000;
+ const size_t STREAM_COUNT = 2000000;
+
+ cout << "========== 性能测试 ==========" << endl;
+ cout << "[时刻解析] " << COUNT << " 条 HH:MM:SS 记录 (GB/s)" << endl;
+
+ // 生成文本，每 1000 条放一条越界记录
+ string text(COUNT * 9, '\0');
+ vector<uint32_t> expected(COUNT);
+ unsigned long long state = 88172645463325252ULL;
+ for (size_t i = 0; i < COUNT; i++)
+ {
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   uint32_t s = (uint32_t)(state % Time::SECONDS_PER_DAY);
+   Time::from_seconds(s).format(&text[i * 9]);
+   text[i * 9 + 8] = '\n';
+   expected[i] = s;
+   if (i % 1000 == 999)
+   {
+     text[i * 9 + 3] = '7';
+     expected[i] = Time::INVALID;
+   }
+ }
+ double gb = text.size() / 1e9;
+
+ // cin 风格：流运算符逐字段读取（只测前 STREAM_COUNT 条）
+ auto t0 = chrono::steady_clock::now();
+ istringstream iss(text.substr(0, STREAM_COUNT * 9));
+ long long streamSum = 0;
+ int h, m, s;
+ char colon;
+ while (iss >> h >> colon >> m >> colon >> s) streamSum += Time(h, m, s).seconds();
+ auto t1 = chrono::steady_clock::now();
+
+ vector<uint32_t> scalar(COUNT), simd(COUNT);
+ size_t badScalar = parse_times_scalar(text.data(), COUNT, 9, scalar.data());
+ auto t2 = chrono::steady_clock::now();
+ size_t badSimd = parse_times(text.data(), COUNT, 9, simd.data());
+ auto t3 = chrono::steady_clock::now();
+
+ string formatted(COUNT * 9, '\0');
+ format_times(simd.data(), COUNT, &formatted[0]);
+ auto t4 = chrono::steady_clock::now();
+ ostringstream oss;
+ for (size_t i = 0; i < STREAM_COUNT; i++)
+ {
+   Time t = Time::from_seconds(expected[i] == Time::INVALID ? 0 : expected[i]);
+   oss << t.get_hour() << ':' << t.get_minute() << ':' << t.get_sec() << '\n';
+ }
+ auto t5 = chrono::steady_clock::now();
+
+ bool ok = scalar == expected && simd == expected && badScalar == COUNT / 1000 && badSimd == badScalar;
+ for (size_t i = 0; i < COUNT && ok; i++)
+ {
+   ok = expected[i] == Time::INVALID || memcmp(&formatted[i * 9], &text[i * 9], 9) == 0;
+ }
+
+ double streamGb = STREAM_COUNT * 9 / 1e9;
+ cout << "流运算符 >>: " << streamGb / (elapsed_ms(t0, t1) / 1000) << endl;
+ cout << "标量批量:    " << gb / (elapsed_ms(t1, t2) / 1000) << endl;
+ cout << "SIMD 批量:   " << gb / (elapsed_ms(t2, t3) / 1000) << endl;
+ cout << "[格式化] 批量: " << gb / (elapsed_ms(t3, t4) / 1000)
+      << ", 流运算符 <<: " << streamGb / (elapsed_ms(t4, t5) / 1000) << endl;
+ cout << "无效记录: " << badSimd << ", 结果一致: " << (ok && streamSum > 0 ? "是" : "否") << endl;
+
+}
+
+
+
+Time t;
+
+
+
+int main(int argc, char* argv[])
+
+{
+
+    if (argc > 1 && string(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+        return 0;
+    }
+
     t.set_time();
 
     t.show_time();
@@ -36,16 +415,21 @@ int main()
 
 
 
+// 读入时、分、秒，超出范围的值按 24 小时制进位归一化
 void Time::set_time(void)
 
 {
 
+ int hour, minute, sec;
+
  cin>>hour;
 
  cin>>minute;
 
  cin>>sec;
 
+ *this = Time(hour, minute, sec);
+
 }
 
 
@@ -54,6 +438,10 @@ void Time::show_time(void)
 
 {
 
-cout<<hour<<":"<<minute<<":"<<sec<<endl;
+ char buf[9];
+
+ format(buf)[0] = '\0';
 
-}
\ No newline at end of file
+ cout<<buf<<endl;
+
+}
@@ -1,14 +1,35 @@
 #include <iostream>
 #include <windows.h> //  Windows API ͷļ
+#include <vector>
+#include <map>
+#include <array>
+#include <string>
+#include <tuple>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
+//  main --bench ִװܲ
+
+// İڷŷиռһλ
+// ǰֱָ߶ȷ򲻱䣨泯ϡְѳ
+const int ORIENT_UPRIGHT = 0x03;
+const int ORIENT_ALL = 0x3F;
+
 class Cuboid {
     private:
         double length;
         double width;
         double height;
-    
+        int orientations = ORIENT_ALL;
+
     public:
         void setDimensions(double l, double w, double h) {
             length = l;
@@ -16,13 +37,502 @@ class Cuboid {
             height = h;
         }
 
-        double getVolume() {
+        void setOrientations(int mask) {
+            orientations = mask & ORIENT_ALL;
+        }
+
+        double getLength() const { return length; }
+        double getWidth() const { return width; }
+        double getHeight() const { return height; }
+        int getOrientations() const { return orientations; }
+
+        double getVolume() const {
             return length * width * height;
         }
+
+        //  k ַ xyz ĳߴ
+        void orientedSize(int k, double& dx, double& dy, double& dz) const {
+            switch (k) {
+                case 0: dx = length; dy = width; dz = height; break;
+                case 1: dx = width; dy = length; dz = height; break;
+                case 2: dx = length; dy = height; dz = width; break;
+                case 3: dx = height; dy = length; dz = width; break;
+                case 4: dx = width; dy = height; dz = length; break;
+                default: dx = height; dy = width; dz = length; break;
+            }
+        }
+};
+
+//==============================================================================
+// ̳߳أrun(n, f)  f(0) ~ f(n-1) ִָ߳вȴȫ
+//==============================================================================
+class ThreadPool {
+    private:
+        vector<thread> workers;
+        mutex mtx;
+        condition_variable start, finished;
+        function<void(int)> task;
+        int taskCount = 0;
+        int nextTask = 0;
+        int running = 0;
+        unsigned long long generation = 0;
+        bool stopping = false;
+
+        // ȡֱȡꣻ߱
+        void drain(unique_lock<mutex>& lock) {
+            while (nextTask < taskCount) {
+                int id = nextTask++;
+                lock.unlock();
+                task(id);
+                lock.lock();
+            }
+        }
+
+        void workerLoop() {
+            unsigned long long seen = 0;
+            unique_lock<mutex> lock(mtx);
+            while (true) {
+                start.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                drain(lock);
+                if (--running == 0) finished.notify_one();
+            }
+        }
+
+    public:
+        explicit ThreadPool(int threads) {
+            for (int i = 1; i < threads; i++) {
+                workers.emplace_back(&ThreadPool::workerLoop, this);
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+            }
+            start.notify_all();
+            for (auto& w : workers) w.join();
+        }
+
+        int size() const { return (int)workers.size() + 1; }
+
+        void run(int n, const function<void(int)>& f) {
+            unique_lock<mutex> lock(mtx);
+            task = f;
+            taskCount = n;
+            nextTask = 0;
+            running = (int)workers.size() + 1;
+            generation++;
+            start.notify_all();
+            drain(lock);
+            running--;
+            finished.wait(lock, [this]() { return running == 0; });
+        }
 };
 
-int main() {
+//==============================================================================
+// άװ䣺㣨extreme pointʽ + ռռ + װ˳
+//==============================================================================
+
+struct Placement {
+    int item;        // е±
+    int container;   // װĵڼ
+    int orientation; // ʹõİڷŷ
+    double x, y, z;  // º
+    double dx, dy, dz;
+};
+
+struct PackResult {
+    vector<Placement> placements;  // װ˳
+    vector<int> unplaced;          // κη򶼷ŲĻ
+    int containers = 0;
+    double packedVolume = 0;
+    double fillRatio = 0;          // װ / 
+    double score = 0;              // ʵƽͣԽ˵Խ
+    int evaluated = 0;             // װ˳
+    int rounds = 0;                // ɵ 0 ֣Ϊ maxRounds ͬһ
+};
+
+struct PackOptions {
+    unsigned seed = 1;
+    int threads = 0;            // 0 ʾ CPU 
+    int maxRounds = 20;         // ÿÿ߳һŶ˳
+    double timeBudgetMs = 0;    //  0 ʱʱٿʼһ֣ѿʼһܻ꣩Ϊ 0 ʱֻ maxRounds ɸ
+    int openContainers = 3;     // ͬʱԵ
+};
+
+const double PACK_EPS = 1e-9;
+
+// ѷŻ (z, y, x) ļ㼯ϡռ
+class ContainerState {
+    private:
+        double L, W, H;
+        double minSide;                 // л̱ߣʣռСļֱӶ
+        int GX, GY, GZ;                 // ߳ԼΪƽ߳
+        vector<vector<int>> cells;      // ÿཻ֮Ļ boxes е±꣩
+        vector<Placement> boxes;
+        // ֻϻϢֻøɣ԰ȫǰų
+        // failed Ϊڸõз򶼷ŲµС򣩣߶СĻͬŲ£
+        // reach Ϊ +x/+y/+z ϰľ룬ǵǰóȵϽ磬version ¼ʱĻ
+        struct PointInfo {
+            array<double, 3> failed;
+            array<double, 3> reach;
+            size_t version;
+        };
+        map<tuple<double, double, double>, PointInfo> points;  // (z, y, x)
+        double used = 0;
+
+        static int cellIndex(double v, double extent, int n) {
+            int c = (int)(v / extent * n);
+            return min(max(c, 0), n - 1);
+        }
+
+        template<typename F>
+        void forCells(double x, double y, double z, double dx, double dy, double dz, F f) const {
+            int x0 = cellIndex(x + PACK_EPS, L, GX), x1 = cellIndex(x + dx - PACK_EPS, L, GX);
+            int y0 = cellIndex(y + PACK_EPS, W, GY), y1 = cellIndex(y + dy - PACK_EPS, W, GY);
+            int z0 = cellIndex(z + PACK_EPS, H, GZ), z1 = cellIndex(z + dz - PACK_EPS, H, GZ);
+            for (int i = x0; i <= x1; i++) {
+                for (int j = y0; j <= y1; j++) {
+                    for (int k = z0; k <= z1; k++) {
+                        if (!f((i * GY + j) * GZ + k)) return;
+                    }
+                }
+            }
+        }
+
+        bool overlaps(double x, double y, double z, double dx, double dy, double dz) const {
+            bool hit = false;
+            forCells(x, y, z, dx, dy, dz, [&](int cell) {
+                for (int b : cells[cell]) {
+                    const Placement& p = boxes[b];
+                    if (x < p.x + p.dx - PACK_EPS && p.x < x + dx - PACK_EPS &&
+                        y < p.y + p.dy - PACK_EPS && p.y < y + dy - PACK_EPS &&
+                        z < p.z + p.dz - PACK_EPS && p.z < z + dz - PACK_EPS) {
+                        hit = true;
+                        return false;
+                    }
+                }
+                return true;
+            });
+            return hit;
+        }
+
+        // ĳѷŻڲ¡ǰ棩ʱӸõŲκλ
+        bool covered(double x, double y, double z) const {
+            bool hit = false;
+            forCells(x, y, z, PACK_EPS * 4, PACK_EPS * 4, PACK_EPS * 4, [&](int cell) {
+                for (int b : cells[cell]) {
+                    const Placement& p = boxes[b];
+                    if (p.x - PACK_EPS <= x && x < p.x + p.dx - PACK_EPS &&
+                        p.y - PACK_EPS <= y && y < p.y + p.dy - PACK_EPS &&
+                        p.z - PACK_EPS <= z && z < p.z + p.dz - PACK_EPS) {
+                        hit = true;
+                        return false;
+                    }
+                }
+                return true;
+            });
+            return hit;
+        }
+
+        void addPoint(double x, double y, double z) {
+            if (L - x >= minSide - PACK_EPS && W - y >= minSide - PACK_EPS && H - z >= minSide - PACK_EPS) {
+                PointInfo info = { { { HUGE_VAL, HUGE_VAL, HUGE_VAL } }, { { L - x, W - y, H - z } }, 0 };
+                points.emplace(make_tuple(z, y, x), info);
+            }
+        }
+
+        //  (x, y, z)  axis 񣬷صľ
+        double ray(double x, double y, double z, int axis) const {
+            double pos[3] = { x, y, z }, extent[3] = { L, W, H };
+            int n[3] = { GX, GY, GZ };
+            int c[3] = { cellIndex(x + PACK_EPS, L, GX), cellIndex(y + PACK_EPS, W, GY), cellIndex(z + PACK_EPS, H, GZ) };
+            double best = extent[axis] - pos[axis];
+            for (int i = c[axis]; i < n[axis]; i++) {
+                c[axis] = i;
+                for (int b : cells[(c[0] * GY + c[1]) * GZ + c[2]]) {
+                    const Placement& p = boxes[b];
+                    double lo[3] = { p.x, p.y, p.z }, size[3] = { p.dx, p.dy, p.dz };
+                    if (lo[axis] < pos[axis] - PACK_EPS) continue;
+                    bool across = true;
+                    for (int a = 0; a < 3 && across; a++) {
+                        if (a != axis) across = lo[a] - PACK_EPS <= pos[a] && pos[a] < lo[a] + size[a] - PACK_EPS;
+                    }
+                    if (across) best = min(best, lo[axis] - pos[axis]);
+                }
+                // УĻֻԶ
+                if (best < (double)(i + 1) / n[axis] * extent[axis] - pos[axis]) break;
+            }
+            return best;
+        }
+
+        bool fitsReach(const array<double, 3>& reach, double dx, double dy, double dz) const {
+            return dx <= reach[0] + PACK_EPS && dy <= reach[1] + PACK_EPS && dz <= reach[2] + PACK_EPS;
+        }
+
+    public:
+        ContainerState(double L, double W, double H, double minSide, double cellSide)
+            : L(L), W(W), H(H), minSide(minSide) {
+            GX = max(1, min(256, (int)(L / cellSide)));
+            GY = max(1, min(256, (int)(W / cellSide)));
+            GZ = max(1, min(256, (int)(H / cellSide)));
+            cells.resize((size_t)GX * GY * GZ);
+            addPoint(0, 0, 0);
+        }
+
+        double usedVolume() const { return used; }
+        double volume() const { return L * W * H; }
+
+        // ˳ҵһܷµλ뷽򣬳ɹʱд placement ¼
+        bool tryPlace(const Cuboid& c, int item, Placement& placement) {
+            if (used + c.getVolume() > volume() + PACK_EPS) return false;
+            array<double, 3> sides = { { c.getLength(), c.getWidth(), c.getHeight() } };
+            sort(sides.begin(), sides.end());
+            bool allOrientations = c.getOrientations() == ORIENT_ALL;
+            double oriented[6][3];
+            int count = 0;
+            for (int k = 0; k < 6; k++) {
+                if (c.getOrientations() >> k & 1) c.orientedSize(k, oriented[k][0], oriented[k][1], oriented[k][2]);
+            }
+            for (auto it = points.begin(); it != points.end();) {
+                double z = get<0>(it->first), y = get<1>(it->first), x = get<2>(it->first);
+                PointInfo& info = it->second;
+                const array<double, 3>& failed = info.failed;
+                if (sides[0] >= failed[0] && sides[1] >= failed[1] && sides[2] >= failed[2]) {
+                    ++it;
+                    continue;
+                }
+                count = 0;
+                for (int k = 0; k < 6; k++) {
+                    if ((c.getOrientations() >> k & 1) && fitsReach(info.reach, oriented[k][0], oriented[k][1], oriented[k][2])) count++;
+                }
+                if (count > 0 && info.version != boxes.size()) {
+                    // ҿܷţ¼㣬˳ѱסʣռ䲻ļ
+                    if (covered(x, y, z)) {
+                        it = points.erase(it);
+                        continue;
+                    }
+                    info.reach = { { ray(x, y, z, 0), ray(x, y, z, 1), ray(x, y, z, 2) } };
+                    info.version = boxes.size();
+                    if (*min_element(info.reach.begin(), info.reach.end()) < minSide - PACK_EPS) {
+                        it = points.erase(it);
+                        continue;
+                    }
+                }
+                for (int k = 0; k < 6 && count > 0; k++) {
+                    if (!(c.getOrientations() >> k & 1)) continue;
+                    double dx = oriented[k][0], dy = oriented[k][1], dz = oriented[k][2];
+                    if (!fitsReach(info.reach, dx, dy, dz)) continue;
+                    if (overlaps(x, y, z, dx, dy, dz)) continue;
+
+                    placement = { item, 0, k, x, y, z, dx, dy, dz };
+                    points.erase(it);
+                    int index = (int)boxes.size();
+                    boxes.push_back(placement);
+                    used += dx * dy * dz;
+                    forCells(x, y, z, dx, dy, dz, [&](int cell) {
+                        cells[cell].push_back(index);
+                        return true;
+                    });
+                    // ¼㣺ǵ
+                    addPoint(x + dx, y, z);
+                    addPoint(x, y + dy, z);
+                    addPoint(x, y, z + dz);
+                    return true;
+                }
+                if (allOrientations && sides[0] * sides[1] * sides[2] < failed[0] * failed[1] * failed[2]) {
+                    info.failed = sides;
+                }
+                ++it;
+            }
+            return false;
+        }
+};
+
+// ˳װ䣺ÿγ򿪵 openLimit Ųʱ
+// Ϊװ䣬ٳԣÿ֮
+PackResult packInOrder(const vector<Cuboid>& items, const vector<int>& order, const Cuboid& container, int openLimit) {
+    PackResult result;
+    vector<ContainerState> open;
+    double L = container.getLength(), W = container.getWidth(), H = container.getHeight();
+    double minSide = L + W + H, sideSum = 0;
+    for (const Cuboid& c : items) {
+        minSide = min(minSide, min(c.getLength(), min(c.getWidth(), c.getHeight())));
+        sideSum += c.getLength() + c.getWidth() + c.getHeight();
+    }
+    double cellSide = items.empty() ? L : sideSum / (3.0 * items.size());
+
+    for (int item : order) {
+        const Cuboid& c = items[item];
+        Placement p;
+        bool placed = false;
+        size_t first = open.size() > (size_t)openLimit ? open.size() - openLimit : 0;
+        for (size_t b = first; b < open.size() && !placed; b++) {
+            placed = open[b].tryPlace(c, item, p);
+            if (placed) p.container = (int)b;
+        }
+        if (!placed) {
+            open.emplace_back(L, W, H, minSide, cellSide);
+            placed = open.back().tryPlace(c, item, p);
+            if (placed) {
+                p.container = (int)open.size() - 1;
+            } else {
+                open.pop_back();
+                result.unplaced.push_back(item);
+                continue;
+            }
+        }
+        result.placements.push_back(p);
+        result.packedVolume += p.dx * p.dy * p.dz;
+    }
+
+    result.containers = (int)open.size();
+    double capacity = container.getVolume() * result.containers;
+    result.fillRatio = capacity > 0 ? result.packedVolume / capacity : 0;
+    for (const auto& s : open) {
+        double f = s.usedVolume() / s.volume();
+        result.score += f * f;
+    }
+    return result;
+}
+
+// ȱװٱȼг̶
+bool betterPacking(const PackResult& a, const PackResult& b) {
+    if (fabs(a.packedVolume - b.packedVolume) > PACK_EPS) return a.packedVolume > b.packedVolume;
+    if (a.containers != b.containers) return a.containers < b.containers;
+    return a.score > b.score + PACK_EPS;
+}
+
+// ֳõĳʼ˳߶ȡߣӴС
+vector<vector<int>> initialOrders(const vector<Cuboid>& items) {
+    vector<function<double(const Cuboid&)>> keys = {
+        [](const Cuboid& c) { return c.getVolume(); },
+        [](const Cuboid& c) { return c.getLength() * c.getWidth(); },
+        [](const Cuboid& c) { return c.getHeight(); },
+        [](const Cuboid& c) { return max(c.getLength(), max(c.getWidth(), c.getHeight())); },
+    };
+    vector<vector<int>> orders;
+    for (auto& key : keys) {
+        vector<int> order(items.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+        stable_sort(order.begin(), order.end(), [&](int a, int b) { return key(items[a]) > key(items[b]); });
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+// ˳ɶڵĻ
+vector<int> perturbOrder(const vector<int>& base, mt19937& rng) {
+    vector<int> order = base;
+    if (order.size() < 2) return order;
+    int swaps = 1 + (int)(rng() % max<size_t>(1, order.size() / 50));
+    for (int s = 0; s < swaps; s++) {
+        size_t i = rng() % order.size();
+        size_t span = 1 + rng() % min<size_t>(order.size() - 1, 16);
+        size_t j = i + span < order.size() ? i + span : i - min(i, span);
+        swap(order[i], order[j]);
+    }
+    return order;
+}
+
+// װڣ 0 ʼ˳֮ÿÿ߳һŶĵǰ˳
+//  r ֵ s ѡֻ (seed, r, s) һֵŽӡ߳ͬʱͬ
+// ʱԤֻ֮飬ÿֶԤʱɼȡڻ
+// ص rounds Ϊ maxRoundsԤΪ 0мɵõͬһ
+PackResult packCuboids(const vector<Cuboid>& items, const Cuboid& container, const PackOptions& options = PackOptions()) {
+    int threads = options.threads > 0 ? options.threads : max(1, (int)thread::hardware_concurrency());
+    ThreadPool pool(threads);
+    auto deadline = chrono::steady_clock::now() + chrono::duration<double, milli>(options.timeBudgetMs);
+    auto withinBudget = [&]() { return options.timeBudgetMs <= 0 || chrono::steady_clock::now() < deadline; };
+
+    vector<vector<int>> candidates = initialOrders(items);
+    vector<PackResult> results(candidates.size());
+    pool.run((int)candidates.size(), [&](int s) { results[s] = packInOrder(items, candidates[s], container, options.openContainers); });
+
+    int bestIndex = 0;
+    for (size_t s = 1; s < results.size(); s++) {
+        if (betterPacking(results[s], results[bestIndex])) bestIndex = (int)s;
+    }
+    PackResult best = results[bestIndex];
+    vector<int> bestOrder = candidates[bestIndex];
+    int evaluated = (int)candidates.size();
+    int rounds = 1;
+
+    for (int round = 1; round < options.maxRounds && withinBudget(); round++) {
+        candidates.assign(threads, vector<int>());
+        results.assign(threads, PackResult());
+        pool.run(threads, [&](int s) {
+            mt19937 rng(options.seed * 1000003u + round * 7919u + s);
+            candidates[s] = perturbOrder(bestOrder, rng);
+            results[s] = packInOrder(items, candidates[s], container, options.openContainers);
+        });
+        for (int s = 0; s < threads; s++) {
+            if (betterPacking(results[s], best)) {
+                best = results[s];
+                bestOrder = candidates[s];
+            }
+        }
+        evaluated += threads;
+        rounds++;
+    }
+
+    best.evaluated = evaluated;
+    best.rounds = rounds;
+    return best;
+}
+
+//==============================================================================
+// ܲ
+//==============================================================================
+void runBenchmarks() {
+    const int COUNT = 20000;
+    mt19937 rng(2024);
+    uniform_real_distribution<double> side(10, 60);
+    vector<Cuboid> items(COUNT);
+    double total = 0;
+    for (int i = 0; i < COUNT; i++) {
+        items[i].setDimensions(round(side(rng)), round(side(rng)), round(side(rng)));
+        if (i % 4 == 0) items[i].setOrientations(ORIENT_UPRIGHT);
+        total += items[i].getVolume();
+    }
+    Cuboid container;
+    container.setDimensions(590, 235, 239);
+    cout << "[װ] " << COUNT << " , Լ " << total / container.getVolume() << " " << endl;
+
+    vector<int> threadCounts = { 1 };
+    int maxThreads = (int)thread::hardware_concurrency();
+    if (maxThreads > 1) threadCounts.push_back(maxThreads);
+    for (int threads : threadCounts) {
+        PackOptions options;
+        options.seed = 42;
+        options.threads = threads;
+        options.maxRounds = 3;          // ʱԤ㣬̶вſɱȽ
+
+        auto t0 = chrono::steady_clock::now();
+        PackResult a = packCuboids(items, container, options);
+        auto t1 = chrono::steady_clock::now();
+        PackResult b = packCuboids(items, container, options);
+        bool same = a.containers == b.containers && a.placements.size() == b.placements.size();
+        for (size_t i = 0; same && i < a.placements.size(); i++) {
+            same = a.placements[i].item == b.placements[i].item && a.placements[i].x == b.placements[i].x
+                && a.placements[i].y == b.placements[i].y && a.placements[i].z == b.placements[i].z;
+        }
+        cout << threads << " ߳: " << chrono::duration<double, milli>(t1 - t0).count() << " ms, "
+             << a.rounds << "  " << a.evaluated << " ˳,  " << a.containers << ",  " << a.fillRatio * 100 << "%"
+             << ", δװ " << a.unplaced.size() << ", νͬ: " << (same ? "" : "") << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(936); // ÿ̨Ϊ GBK (936) GB2312
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        runBenchmarks();
+        return 0;
+    }
+
     Cuboid cuboids[3];
     double l, w, h;
 
@@ -38,4 +548,3 @@ int main() {
 
     return 0;
 }
-
@@ -1,8 +1,371 @@
 #include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
 
 using namespace std;
 
-int main() {
+// 运行 main --bench 执行性能测试
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MIN_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+//==============================================================================
+// 数组最小值 / 最大值 / 最小值下标
+// 浮点数组不能含 NaN：标量比较与 SIMD min/max 对 NaN 的处理不同
+//==============================================================================
+
+template<typename T>
+T array_min_scalar(const T* a, size_t n) {
+    T m = a[0];
+    for (size_t i = 1; i < n; i++) {
+        if (a[i] < m) m = a[i];
+    }
+    return m;
+}
+
+template<typename T>
+T array_max_scalar(const T* a, size_t n) {
+    T m = a[0];
+    for (size_t i = 1; i < n; i++) {
+        if (m < a[i]) m = a[i];
+    }
+    return m;
+}
+
+// 第一个等于 value 的下标，找不到时返回 n
+template<typename T>
+size_t find_first_scalar(const T* a, size_t n, T value) {
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] == value) return i;
+    }
+    return n;
+}
+
+#ifdef MIN_X86_DISPATCH
+
+// 各元素类型的 256 位向量操作，供下面的通用 AVX2 循环使用
+template<typename T> struct Avx2Ops;
+
+template<> struct Avx2Ops<int> {
+    typedef __m256i V;
+    static const size_t LANES = 8;
+    __attribute__((target("avx2"))) static V load(const int* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    __attribute__((target("avx2"))) static V set1(int v) { return _mm256_set1_epi32(v); }
+    __attribute__((target("avx2"))) static V vmin(V a, V b) { return _mm256_min_epi32(a, b); }
+    __attribute__((target("avx2"))) static V vmax(V a, V b) { return _mm256_max_epi32(a, b); }
+    __attribute__((target("avx2"))) static int eq_mask(V a, V b) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+    }
+    __attribute__((target("avx2"))) static void store(int* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+};
+
+template<> struct Avx2Ops<float> {
+    typedef __m256 V;
+    static const size_t LANES = 8;
+    __attribute__((target("avx2"))) static V load(const float* p) { return _mm256_loadu_ps(p); }
+    __attribute__((target("avx2"))) static V set1(float v) { return _mm256_set1_ps(v); }
+    __attribute__((target("avx2"))) static V vmin(V a, V b) { return _mm256_min_ps(a, b); }
+    __attribute__((target("avx2"))) static V vmax(V a, V b) { return _mm256_max_ps(a, b); }
+    __attribute__((target("avx2"))) static int eq_mask(V a, V b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+    __attribute__((target("avx2"))) static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+};
+
+template<> struct Avx2Ops<double> {
+    typedef __m256d V;
+    static const size_t LANES = 4;
+    __attribute__((target("avx2"))) static V load(const double* p) { return _mm256_loadu_pd(p); }
+    __attribute__((target("avx2"))) static V set1(double v) { return _mm256_set1_pd(v); }
+    __attribute__((target("avx2"))) static V vmin(V a, V b) { return _mm256_min_pd(a, b); }
+    __attribute__((target("avx2"))) static V vmax(V a, V b) { return _mm256_max_pd(a, b); }
+    __attribute__((target("avx2"))) static int eq_mask(V a, V b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+    __attribute__((target("avx2"))) static void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+};
+
+// 4 个独立累加向量隐藏 min/max 指令延迟，最后归并到一个标量；尾部交给标量循环
+template<typename T, bool IS_MAX>
+__attribute__((target("avx2")))
+T array_extreme_avx2(const T* a, size_t n) {
+    typedef Avx2Ops<T> Ops;
+    const size_t W = Ops::LANES;
+    if (n < 4 * W) return IS_MAX ? array_max_scalar(a, n) : array_min_scalar(a, n);
+
+    typename Ops::V acc0 = Ops::load(a), acc1 = Ops::load(a + W), acc2 = Ops::load(a + 2 * W), acc3 = Ops::load(a + 3 * W);
+    size_t i = 4 * W;
+    for (; i + 4 * W <= n; i += 4 * W) {
+        if (IS_MAX) {
+            acc0 = Ops::vmax(acc0, Ops::load(a + i));
+            acc1 = Ops::vmax(acc1, Ops::load(a + i + W));
+            acc2 = Ops::vmax(acc2, Ops::load(a + i + 2 * W));
+            acc3 = Ops::vmax(acc3, Ops::load(a + i + 3 * W));
+        } else {
+            acc0 = Ops::vmin(acc0, Ops::load(a + i));
+            acc1 = Ops::vmin(acc1, Ops::load(a + i + W));
+            acc2 = Ops::vmin(acc2, Ops::load(a + i + 2 * W));
+            acc3 = Ops::vmin(acc3, Ops::load(a + i + 3 * W));
+        }
+    }
+    typename Ops::V acc = IS_MAX ? Ops::vmax(Ops::vmax(acc0, acc1), Ops::vmax(acc2, acc3))
+                                 : Ops::vmin(Ops::vmin(acc0, acc1), Ops::vmin(acc2, acc3));
+    T lanes[8];
+    Ops::store(lanes, acc);
+    T m = lanes[0];
+    for (size_t k = 1; k < W; k++) {
+        if (IS_MAX ? m < lanes[k] : lanes[k] < m) m = lanes[k];
+    }
+    for (; i < n; i++) {
+        if (IS_MAX ? m < a[i] : a[i] < m) m = a[i];
+    }
+    return m;
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+size_t find_first_avx2(const T* a, size_t n, T value) {
+    typedef Avx2Ops<T> Ops;
+    const size_t W = Ops::LANES;
+    typename Ops::V v = Ops::set1(value);
+    size_t i = 0;
+    for (; i + W <= n; i += W) {
+        int mask = Ops::eq_mask(Ops::load(a + i), v);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + find_first_scalar(a + i, n - i, value);
+}
+
+inline bool cpu_has_avx2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+
+#endif
+
+inline void require_nonempty(size_t n) {
+    if (n == 0) throw invalid_argument("空数组没有最小值或最大值");
+}
+
+template<typename T>
+T array_min(const T* a, size_t n) {
+    require_nonempty(n);
+#ifdef MIN_X86_DISPATCH
+    if (cpu_has_avx2()) return array_extreme_avx2<T, false>(a, n);
+#endif
+    return array_min_scalar(a, n);
+}
+
+template<typename T>
+T array_max(const T* a, size_t n) {
+    require_nonempty(n);
+#ifdef MIN_X86_DISPATCH
+    if (cpu_has_avx2()) return array_extreme_avx2<T, true>(a, n);
+#endif
+    return array_max_scalar(a, n);
+}
+
+// 最小值第一次出现的下标：先向量求最小值，再向量查找第一个相等的元素
+// 两遍都是顺序读，比单遍同时跟踪值与下标的向量循环更简单，速度也相当
+template<typename T>
+size_t array_argmin(const T* a, size_t n) {
+    T m = array_min(a, n);
+#ifdef MIN_X86_DISPATCH
+    if (cpu_has_avx2()) return find_first_avx2(a, n, m);
+#endif
+    return find_first_scalar(a, n, m);
+}
+
+template<typename T>
+size_t array_argmax(const T* a, size_t n) {
+    T m = array_max(a, n);
+#ifdef MIN_X86_DISPATCH
+    if (cpu_has_avx2()) return find_first_avx2(a, n, m);
+#endif
+    return find_first_scalar(a, n, m);
+}
+
+//==============================================================================
+// 流式滑动窗口最小值 / 最大值（单调队列）
+// 队列中保存窗口内“还可能成为答案”的元素，从队头到队尾严格按 Compare 递增，
+// 队头即当前答案；每个元素最多入队、出队各一次，均摊 O(1)
+//==============================================================================
+
+template<typename T, typename Compare = less<T>>
+class SlidingWindowExtreme {
+    private:
+        size_t window;
+        size_t mask;                // 环形缓冲区容量为 2 的幂，下标用 & mask 回绕
+        vector<T> values;
+        vector<unsigned long long> positions;
+        size_t head = 0, tail = 0;  // 队列占用 [head, tail)，访问时再与 mask 取模
+        unsigned long long pushed = 0;
+        Compare comp;
+
+    public:
+        explicit SlidingWindowExtreme(size_t window, Compare comp = Compare()) : window(window), comp(comp) {
+            if (window == 0) throw invalid_argument("滑动窗口长度必须大于 0");
+            size_t capacity = 1;
+            while (capacity <= window) capacity <<= 1;   // 新元素先入队、旧队头后出队，最多同时有 window + 1 个
+            mask = capacity - 1;
+            values.resize(capacity);
+            positions.resize(capacity);
+        }
+
+        size_t windowSize() const { return window; }
+        unsigned long long count() const { return pushed; }
+        bool empty() const { return pushed == 0; }
+
+        // 当前窗口（最近 window 个元素，不足时为全部已读元素）的答案
+        T current() const {
+            if (pushed == 0) throw logic_error("滑动窗口中还没有元素");
+            return values[head & mask];
+        }
+
+        void reset() {
+            head = tail = 0;
+            pushed = 0;
+        }
+
+        T push(T value) {
+            push(&value, 1, nullptr);
+            return values[head & mask];
+        }
+
+        // 批量读入 n 个元素；out 非空时写入每读入一个元素后的窗口答案
+        // 单个 push 也由它实现，内联后两者速度相同（耗时主要在出队循环的分支预测），批量接口只是方便按块处理
+        void push(const T* in, size_t n, T* out) {
+            T* vals = values.data();
+            unsigned long long* pos = positions.data();
+            size_t h = head, t = tail;
+            unsigned long long p = pushed;
+            for (size_t i = 0; i < n; i++, p++) {
+                T v = in[i];
+                while (t != h && !comp(vals[(t - 1) & mask], v)) t--;
+                vals[t & mask] = v;
+                pos[t & mask] = p;
+                t++;
+                if (pos[h & mask] + window <= p) h++;
+                if (out) out[i] = vals[h & mask];
+            }
+            head = h;
+            tail = t;
+            pushed = p;
+        }
+};
+
+template<typename T> using SlidingWindowMin = SlidingWindowExtreme<T, less<T>>;
+template<typename T> using SlidingWindowMax = SlidingWindowExtreme<T, greater<T>>;
+
+//==============================================================================
+// 性能测试
+//==============================================================================
+
+double elapsed_ms(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+    return chrono::duration<double, milli>(b - a).count();
+}
+
+template<typename T>
+void bench_reduction(const char* name, const vector<T>& data, int repeats) {
+    const T* a = data.data();
+    size_t n = data.size();
+    T sm = T(), vm = T();
+    size_t si = 0, vi = 0;
+
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        sm = array_min_scalar(a, n);
+        si = find_first_scalar(a, n, sm);
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        vm = array_min(a, n);
+        vi = array_argmin(a, n);
+    }
+    auto t2 = chrono::steady_clock::now();
+    bool ok = sm == vm && si == vi && array_max(a, n) == array_max_scalar(a, n)
+        && array_argmax(a, n) == find_first_scalar(a, n, array_max_scalar(a, n));
+
+    double gb = (double)n * sizeof(T) * 2 * repeats / 1e9;  // min 与 argmin 各读一遍
+    cout << name << ": 标量 " << gb / (elapsed_ms(t0, t1) / 1000) << " GB/s, SIMD "
+         << gb / (elapsed_ms(t1, t2) / 1000) << " GB/s, 最小值下标 " << vi
+         << ", 结果一致: " << (ok ? "是" : "否") << endl;
+}
+
+void run_benchmarks() {
+    const size_t COUNT = 8000000;
+    const int REPEATS = 5;
+    mt19937 rng(2024);
+
+    cout << "========== 性能测试 ==========" << endl;
+    cout << "[min/argmin] " << COUNT << " 个元素, 重复 " << REPEATS << " 次" << endl;
+    {
+        uniform_int_distribution<int> d(-1000000000, 1000000000);
+        vector<int> data(COUNT);
+        for (auto& v : data) v = d(rng);
+        bench_reduction("int   ", data, REPEATS);
+    }
+    {
+        uniform_real_distribution<float> d(-1e6f, 1e6f);
+        vector<float> data(COUNT);
+        for (auto& v : data) v = d(rng);
+        bench_reduction("float ", data, REPEATS);
+    }
+    {
+        uniform_real_distribution<double> d(-1e6, 1e6);
+        vector<double> data(COUNT);
+        for (auto& v : data) v = d(rng);
+        bench_reduction("double", data, REPEATS);
+    }
+
+    // 模拟延迟流：大多数样本在 1~5 ms，偶尔有尖峰
+    const size_t STREAM = 20000000;
+    const size_t NAIVE = 200000;
+    const size_t WINDOW = 1000;
+    vector<double> latency(STREAM);
+    uniform_real_distribution<double> base(1.0, 5.0), spike(0.0, 1.0);
+    for (auto& v : latency) v = base(rng) * (spike(rng) < 0.001 ? 50 : 1);
+    cout << "[滑动窗口最小值] 窗口 " << WINDOW << ", 流长度 " << STREAM << " (百万元素/秒)" << endl;
+
+    // 每个窗口重新计算（只测前 NAIVE 个元素）
+    vector<double> naive(NAIVE), single(STREAM), batched(STREAM);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < NAIVE; i++) {
+        size_t from = i + 1 >= WINDOW ? i + 1 - WINDOW : 0;
+        naive[i] = array_min_scalar(&latency[from], i + 1 - from);
+    }
+    auto t1 = chrono::steady_clock::now();
+    SlidingWindowMin<double> one(WINDOW);
+    for (size_t i = 0; i < STREAM; i++) single[i] = one.push(latency[i]);
+    auto t2 = chrono::steady_clock::now();
+    SlidingWindowMin<double> batch(WINDOW);
+    const size_t CHUNK = 4096;   // 模拟按包到达的数据
+    for (size_t i = 0; i < STREAM; i += CHUNK) {
+        batch.push(&latency[i], min(CHUNK, STREAM - i), &batched[i]);
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    SlidingWindowMax<double> peak(WINDOW);
+    peak.push(latency.data(), STREAM, nullptr);
+    double lastMax = array_max(&latency[STREAM - WINDOW], WINDOW);
+
+    bool ok = single == batched && peak.current() == lastMax;
+    for (size_t i = 0; i < NAIVE && ok; i++) ok = naive[i] == single[i];
+    cout << "逐窗口重算: " << NAIVE / elapsed_ms(t0, t1) / 1000
+         << ", 单调队列逐个: " << STREAM / elapsed_ms(t1, t2) / 1000
+         << ", 单调队列批量: " << STREAM / elapsed_ms(t2, t3) / 1000
+         << ", 结果一致: " << (ok ? "是" : "否") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        run_benchmarks();
+        return 0;
+    }
+
     int a, b, c;
     int f(int x, int y, int z);
     cin>>a>>b>>c;
@@ -16,4 +379,4 @@ int f(int x, int y, int z) {
     if(x<y) m=x; else m=y;
     if(z<m) m=z;
     return(m);
-}
\ No newline at end of file
+}
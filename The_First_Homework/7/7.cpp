@@ -1,19 +1,662 @@
-#include<iostream> 
+#include<iostream>
+#include<string>
+#include<vector>
+#include<deque>
+#include<mutex>
+#include<chrono>
+#include<random>
+#include<algorithm>
+#include<stdexcept>
+#include<cstring>
 
-using namespace std; 
+using namespace std;
 
-int add(int x, int y);
+// 运行 main --bench 执行性能测试
 
-int main() { 
-    int a,b,c;  
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BIGINT_X86_64 1
+#include <immintrin.h>
+#endif
+
+//==============================================================================
+// 任意精度整数：符号 + 2^64 进制的小端 limb 数组
+// 十进制转换用分治：按 10^(19*2^k) 拆分，乘法用 Karatsuba，除法用预计算倒数的 Barrett 约减
+//==============================================================================
+
+typedef unsigned long long limb_t;
+
+const limb_t DEC_BASE = 10000000000000000000ULL;  // 10^19，一个 limb 能放下的最大 10 的幂
+const int DEC_DIGITS = 19;
+const size_t KARATSUBA_THRESHOLD = 32;    // limb 数少于它时用竖式乘法
+const size_t PARSE_DC_THRESHOLD = 1200;   // 十进制位数少于它时逐段乘加解析
+const size_t PRINT_DC_THRESHOLD = 40;     // limb 数少于它时逐次除以 10^9 输出
+
+inline unsigned char add_carry(unsigned char c, limb_t a, limb_t b, limb_t* out) {
+#ifdef BIGINT_X86_64
+    return _addcarry_u64(c, a, b, out);
+#else
+    limb_t s = a + b;
+    limb_t t = s + c;
+    *out = t;
+    return (s < a) | (t < s);
+#endif
+}
+
+inline unsigned char sub_borrow(unsigned char c, limb_t a, limb_t b, limb_t* out) {
+#ifdef BIGINT_X86_64
+    return _subborrow_u64(c, a, b, out);
+#else
+    limb_t d = a - b;
+    limb_t t = d - c;
+    *out = t;
+    return (a < b) | (d < c);
+#endif
+}
+
+// 64 x 64 -> 128 位乘法，返回高 64 位
+inline limb_t mul_wide(limb_t a, limb_t b, limb_t* lo) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *lo = (limb_t)p;
+    return (limb_t)(p >> 64);
+#else
+    limb_t a0 = a & 0xFFFFFFFFu, a1 = a >> 32, b0 = b & 0xFFFFFFFFu, b1 = b >> 32;
+    limb_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    limb_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+    *lo = (mid << 32) | (p00 & 0xFFFFFFFFu);
+    return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+// r[0..n) = a[0..n) + b[0..m)（n >= m），返回最高位进位；r 可以与 a 或 b 相同
+limb_t mag_add(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+    unsigned char c = 0;
+    size_t i = 0;
+    for (; i + 4 <= m; i += 4) {
+        c = add_carry(c, a[i], b[i], &r[i]);
+        c = add_carry(c, a[i + 1], b[i + 1], &r[i + 1]);
+        c = add_carry(c, a[i + 2], b[i + 2], &r[i + 2]);
+        c = add_carry(c, a[i + 3], b[i + 3], &r[i + 3]);
+    }
+    for (; i < m; i++) c = add_carry(c, a[i], b[i], &r[i]);
+    // 进位只在 a 的剩余部分全为 1 时继续传播，提前结束后直接拷贝
+    for (; i < n && c; i++) c = add_carry(c, a[i], 0, &r[i]);
+    if (r != a && i < n) memcpy(r + i, a + i, (n - i) * sizeof(limb_t));
+    return c;
+}
+
+// r[0..n) = a[0..n) - b[0..m)（n >= m），返回借位；r 可以与 a 或 b 相同
+limb_t mag_sub(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+    unsigned char c = 0;
+    size_t i = 0;
+    for (; i + 4 <= m; i += 4) {
+        c = sub_borrow(c, a[i], b[i], &r[i]);
+        c = sub_borrow(c, a[i + 1], b[i + 1], &r[i + 1]);
+        c = sub_borrow(c, a[i + 2], b[i + 2], &r[i + 2]);
+        c = sub_borrow(c, a[i + 3], b[i + 3], &r[i + 3]);
+    }
+    for (; i < m; i++) c = sub_borrow(c, a[i], b[i], &r[i]);
+    for (; i < n && c; i++) c = sub_borrow(c, a[i], 0, &r[i]);
+    if (r != a && i < n) memcpy(r + i, a + i, (n - i) * sizeof(limb_t));
+    return c;
+}
+
+int mag_compare(const limb_t* a, size_t n, const limb_t* b, size_t m) {
+    if (n != m) return n < m ? -1 : 1;
+    for (size_t i = n; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// r[0..n) += a[0..n) * b，返回溢出到 r[n] 的部分
+limb_t mag_addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t lo, hi = mul_wide(a[i], b, &lo);
+        hi += add_carry(0, lo, carry, &lo);
+        hi += add_carry(0, r[i], lo, &r[i]);
+        carry = hi;
+    }
+    return carry;
+}
+
+// r[0..n+m) = a * b，r 不能与输入重叠
+void mag_mul(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+    if (n < m) {
+        swap(a, b);
+        swap(n, m);
+    }
+    fill(r, r + n + m, 0);
+    if (m == 0) return;
+
+    if (m < KARATSUBA_THRESHOLD) {
+        for (size_t j = 0; j < m; j++) r[n + j] = mag_addmul_1(r + j, a, n, b[j]);
+        return;
+    }
+
+    size_t h = (n + 1) / 2;
+    if (m <= h) {
+        // 长短悬殊：把 a 按 m 分块，每块与 b 做平衡的乘法后累加
+        vector<limb_t> t(2 * m);
+        for (size_t i = 0; i < n; i += m) {
+            size_t len = min(m, n - i);
+            mag_mul(t.data(), a + i, len, b, m);
+            mag_add(r + i, r + i, n + m - i, t.data(), len + m);
+        }
+        return;
+    }
+
+    // a = a1*B^h + a0, b = b1*B^h + b0
+    // a*b = z2*B^2h + ((a0+a1)(b0+b1) - z0 - z2)*B^h + z0
+    size_t na1 = n - h, nb1 = m - h;
+    vector<limb_t> sa(h + 1), sb(h + 1), z1(2 * h + 2);
+    sa[h] = mag_add(sa.data(), a, h, a + h, na1);
+    sb[h] = mag_add(sb.data(), b, h, b + h, nb1);
+    mag_mul(r, a, h, b, h);                     // z0 -> r[0, 2h)
+    mag_mul(r + 2 * h, a + h, na1, b + h, nb1); // z2 -> r[2h, n+m)
+    mag_mul(z1.data(), sa.data(), h + 1, sb.data(), h + 1);
+    mag_sub(z1.data(), z1.data(), z1.size(), r, 2 * h);
+    mag_sub(z1.data(), z1.data(), z1.size(), r + 2 * h, na1 + nb1);
+    size_t len = z1.size();
+    while (len > 0 && z1[len - 1] == 0) len--;
+    mag_add(r + h, r + h, n + m - h, z1.data(), len);
+}
+
+class BigInt {
+    private:
+        vector<limb_t> mag;   // 小端，无前导 0；零为空数组
+        bool negative = false;
+
+        void trim() {
+            while (!mag.empty() && mag.back() == 0) mag.pop_back();
+            if (mag.empty()) negative = false;
+        }
+
+        static BigInt from_magnitude(vector<limb_t> m, bool neg = false) {
+            BigInt r;
+            r.mag = move(m);
+            r.negative = neg;
+            r.trim();
+            return r;
+        }
+
+        // this += (neg ? -1 : 1) * b[0..m)，原地进行，尽量复用已有容量
+        void add_signed(const limb_t* b, size_t m, bool neg);
+
+        // 十进制 <-> 二进制的分治转换
+        static vector<limb_t> parse_magnitude(const char* p, size_t len);
+        static void parse_small(const char* p, size_t len, vector<limb_t>& out);
+        void print_digits(string& out, size_t width) const;
+        void print_small(string& out, size_t width) const;
+
+    public:
+        BigInt() {}
+        BigInt(long long v) {
+            negative = v < 0;
+            limb_t u = negative ? 0 - (limb_t)v : (limb_t)v;
+            if (u) mag.push_back(u);
+        }
+
+        // 可选正负号后跟至少一位数字，否则抛出 invalid_argument
+        static BigInt from_string(const string& s);
+        string to_string() const;
+
+        bool is_zero() const { return mag.empty(); }
+        bool is_negative() const { return negative; }
+        size_t limbs() const { return mag.size(); }
+
+        BigInt& operator+=(const BigInt& b) { add_signed(b.mag.data(), b.mag.size(), b.negative); return *this; }
+        BigInt& operator-=(const BigInt& b) { add_signed(b.mag.data(), b.mag.size(), !b.negative); return *this; }
+        BigInt operator-() const { BigInt r = *this; if (!r.mag.empty()) r.negative = !r.negative; return r; }
+
+        friend BigInt operator+(BigInt a, const BigInt& b) { a += b; return a; }
+        friend BigInt operator-(BigInt a, const BigInt& b) { a -= b; return a; }
+        friend BigInt operator*(const BigInt& a, const BigInt& b) {
+            if (a.mag.empty() || b.mag.empty()) return BigInt();
+            vector<limb_t> r(a.mag.size() + b.mag.size());
+            mag_mul(r.data(), a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+            return from_magnitude(move(r), a.negative != b.negative);
+        }
+
+        // 乘以 / 整除 2^(64k)（向零截断）
+        BigInt shift_limbs_left(size_t k) const {
+            if (mag.empty()) return BigInt();
+            vector<limb_t> r(k, 0);
+            r.insert(r.end(), mag.begin(), mag.end());
+            return from_magnitude(move(r), negative);
+        }
+        BigInt shift_limbs_right(size_t k) const {
+            if (k >= mag.size()) return BigInt();
+            return from_magnitude(vector<limb_t>(mag.begin() + k, mag.end()), negative);
+        }
+
+        friend int compare(const BigInt& a, const BigInt& b) {
+            if (a.negative != b.negative) return a.negative ? -1 : 1;
+            int c = mag_compare(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+            return a.negative ? -c : c;
+        }
+        friend bool operator==(const BigInt& a, const BigInt& b) { return compare(a, b) == 0; }
+        friend bool operator!=(const BigInt& a, const BigInt& b) { return compare(a, b) != 0; }
+        friend bool operator<(const BigInt& a, const BigInt& b) { return compare(a, b) < 0; }
+        friend bool operator>=(const BigInt& a, const BigInt& b) { return compare(a, b) >= 0; }
+
+        friend ostream& operator<<(ostream& os, const BigInt& v) { return os << v.to_string(); }
+};
+
+void BigInt::add_signed(const limb_t* b, size_t m, bool neg) {
+    if (m == 0) return;
+    if (b == mag.data()) {
+        // x += x 或 x -= x：下面会改写 mag，先复制一份
+        vector<limb_t> copy(b, b + m);
+        add_signed(copy.data(), m, neg);
+        return;
+    }
+    if (mag.empty()) negative = neg;
+    size_t n = mag.size();
+    if (neg == negative) {
+        limb_t c;
+        if (n < m) {
+            mag.resize(m, 0);
+            c = mag_add(mag.data(), b, m, mag.data(), n);
+        } else {
+            c = mag_add(mag.data(), mag.data(), n, b, m);
+        }
+        if (c) mag.push_back(c);
+        return;
+    }
+    if (mag_compare(mag.data(), n, b, m) >= 0) {
+        mag_sub(mag.data(), mag.data(), n, b, m);
+    } else {
+        // |this| < |b|：结果为 b - this，符号随 b
+        mag.resize(m, 0);
+        mag_sub(mag.data(), b, m, mag.data(), n);
+        negative = neg;
+    }
+    trim();
+}
+
+//==============================================================================
+// 10 的幂缓存：第 k 层为 10^(19*2^k) 及其 Barrett 倒数 floor(B^(2m) / P)，m 为其 limb 数
+//==============================================================================
+
+struct Pow10Level {
+    BigInt power;
+    size_t digits;
+    BigInt inverse;
+    bool has_inverse = false;
+};
+
+// B^(2m) / P 的整数部分，P 恰有 m 个 limb
+BigInt reciprocal(const BigInt& p, size_t m) {
+    BigInt top = BigInt(1).shift_limbs_left(2 * m);
+    if (m <= 4) {
+        // 小规模直接按二进制竖式除法：被除数 B^2m 只有最高位为 1
+        BigInt q, r;
+        for (size_t bit = 2 * m * 64 + 1; bit-- > 0;) {
+            r = r + r;
+            if (bit == 2 * m * 64) r += BigInt(1);
+            q = q + q;
+            if (r >= p) {
+                r -= p;
+                q += BigInt(1);
+            }
+        }
+        return q;
+    }
+
+    // 用高 h 个 limb 的倒数作初值，做一次牛顿迭代 X1 = X0 + X0 * (B^2m - P*X0) / B^2m
+    // 初值相对误差不超过 B^-(h-1)，迭代后平方；X1 约为 B^m 量级，取 h = m/2 + 2 时
+    // 绝对误差小于 1 个单位（加上截断误差只差几个单位），最后逐一修正
+    size_t h = m / 2 + 2;
+    BigInt x = reciprocal(p.shift_limbs_right(m - h), h).shift_limbs_left(m - h);
+    BigInt e = top - p * x;
+    x += (x * e).shift_limbs_right(2 * m);
+    BigInt r = top - p * x;
+    while (r.is_negative()) {
+        x -= BigInt(1);
+        r += p;
+    }
+    while (r >= p) {
+        x += BigInt(1);
+        r -= p;
+    }
+    return x;
+}
+
+const Pow10Level& pow10_level(size_t k, bool need_inverse) {
+    static deque<Pow10Level> levels;  // deque 追加元素时不会使已有元素的引用失效
+    static mutex mtx;
+    lock_guard<mutex> lock(mtx);
+    while (levels.size() <= k) {
+        Pow10Level level;
+        if (levels.empty()) {
+            level.power = BigInt((long long)(DEC_BASE / 10)) * BigInt(10);
+            level.digits = DEC_DIGITS;
+        } else {
+            level.power = levels.back().power * levels.back().power;
+            level.digits = levels.back().digits * 2;
+        }
+        levels.push_back(move(level));
+    }
+    Pow10Level& level = levels[k];
+    if (need_inverse && !level.has_inverse) {
+        level.inverse = reciprocal(level.power, level.power.limbs());
+        level.has_inverse = true;
+    }
+    return level;
+}
+
+void BigInt::parse_small(const char* p, size_t len, vector<limb_t>& out) {
+    out.clear();
+    size_t first = len % DEC_DIGITS ? len % DEC_DIGITS : DEC_DIGITS;
+    for (size_t pos = 0; pos < len;) {
+        size_t take = pos == 0 ? first : DEC_DIGITS;
+        limb_t chunk = 0, scale = 1;
+        for (size_t i = 0; i < take; i++) {
+            chunk = chunk * 10 + (limb_t)(p[pos + i] - '0');
+            scale *= 10;
+        }
+        pos += take;
+        // out = out * scale + chunk
+        limb_t carry = chunk;
+        for (size_t i = 0; i < out.size(); i++) {
+            limb_t lo, hi = mul_wide(out[i], scale, &lo);
+            hi += add_carry(0, lo, carry, &out[i]);
+            carry = hi;
+        }
+        if (carry) out.push_back(carry);
+    }
+}
+
+// 高位部分 * 10^(19*2^k) + 低 19*2^k 位，k 取使低位部分不超过一半的最大值
+vector<limb_t> BigInt::parse_magnitude(const char* p, size_t len) {
+    if (len < PARSE_DC_THRESHOLD) {
+        vector<limb_t> out;
+        parse_small(p, len, out);
+        return out;
+    }
+    size_t k = 0;
+    while (pow10_level(k + 1, false).digits * 2 < len) k++;
+    const Pow10Level& level = pow10_level(k, false);
+    size_t low_len = level.digits;
+    BigInt high = from_magnitude(parse_magnitude(p, len - low_len));
+    BigInt low = from_magnitude(parse_magnitude(p + len - low_len, low_len));
+    BigInt r = high * level.power;
+    r += low;
+    return move(r.mag);
+}
+
+BigInt BigInt::from_string(const string& s) {
+    size_t i = 0;
+    bool neg = false;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-')) neg = s[i++] == '-';
+    if (i == s.size()) throw invalid_argument("不是合法的整数: \"" + s + "\"");
+    for (size_t j = i; j < s.size(); j++) {
+        if (s[j] < '0' || s[j] > '9') throw invalid_argument("不是合法的整数: \"" + s + "\"");
+    }
+    while (i + 1 < s.size() && s[i] == '0') i++;
+    return from_magnitude(parse_magnitude(s.data() + i, s.size() - i), neg);
+}
+
+// 逐次除以 10^9，每次从高位到低位把 limb 拆成两个 32 位半字做短除法，只用 64 位运算
+void BigInt::print_small(string& out, size_t width) const {
+    vector<limb_t> t = mag;
+    vector<unsigned> groups;   // 低位在前，每组 9 位
+    while (!t.empty()) {
+        limb_t rem = 0;
+        for (size_t i = t.size(); i-- > 0;) {
+            limb_t hi = (rem << 32) | (t[i] >> 32);
+            limb_t qh = hi / 1000000000u;
+            rem = hi % 1000000000u;
+            limb_t lo = (rem << 32) | (t[i] & 0xFFFFFFFFu);
+            limb_t ql = lo / 1000000000u;
+            rem = lo % 1000000000u;
+            t[i] = (qh << 32) | ql;
+        }
+        groups.push_back((unsigned)rem);
+        while (!t.empty() && t.back() == 0) t.pop_back();
+    }
+
+    char buf[9];
+    string digits;
+    for (size_t g = groups.size(); g-- > 0;) {
+        unsigned v = groups[g];
+        for (int d = 8; d >= 0; d--) {
+            buf[d] = (char)('0' + v % 10);
+            v /= 10;
+        }
+        digits.append(buf, 9);
+    }
+    size_t start = digits.find_first_not_of('0');
+    if (start == string::npos) start = digits.size();
+    size_t len = digits.size() - start;
+    if (width > len) out.append(width - len, '0');
+    out.append(digits, start, string::npos);
+}
+
+// 输出 |this|，不足 width 位时左侧补 0
+void BigInt::print_digits(string& out, size_t width) const {
+    if (mag.size() < PRINT_DC_THRESHOLD) {
+        print_small(out, width);
+        return;
+    }
+    // 找最小的 k 使 |this| < P_k^2，则商与余数都小于 P_k
+    size_t k = 0;
+    while (mag_compare(mag.data(), mag.size(), pow10_level(k + 1, false).power.mag.data(),
+                       pow10_level(k + 1, false).power.mag.size()) >= 0) k++;
+    const Pow10Level& level = pow10_level(k, true);
+    const BigInt& p = level.power;
+    size_t m = p.limbs();
+
+    // Barrett：q = ((x / B^(m-1)) * mu) / B^(m+1)，偏小不超过 2
+    BigInt x = from_magnitude(mag);
+    BigInt q = (x.shift_limbs_right(m - 1) * level.inverse).shift_limbs_right(m + 1);
+    BigInt r = x - q * p;
+    while (r >= p) {
+        r -= p;
+        q += BigInt(1);
+    }
+    q.print_digits(out, width > level.digits ? width - level.digits : 0);
+    r.print_digits(out, level.digits);
+}
+
+string BigInt::to_string() const {
+    if (mag.empty()) return "0";
+    string out;
+    out.reserve(mag.size() * 20 + 1);
+    if (negative) out.push_back('-');
+    print_digits(out, 0);
+    return out;
+}
+
+//==============================================================================
+// 批量求和：十进制字符串按 10^18 进制逐段累加，不逐个转成二进制；
+// 进位延迟到每 CARRY_INTERVAL 次累加统一处理，取结果时才做一次分治的十进制到二进制转换
+//==============================================================================
+
+class BigSum {
+    private:
+        static const limb_t GROUP_BASE = 1000000000000000000ULL;  // 10^18
+        static const size_t GROUP_DIGITS = 18;
+        static const int CARRY_INTERVAL = 17;  // 各分量小于 10^18，再累加 17 次仍小于 2^64
+
+        BigInt total;               // 以 BigInt 形式加入的部分
+        vector<limb_t> pos, neg;    // 正数之和、负数绝对值之和：10^18 进制，低位在前，进位尚未处理
+        int pending = 0;            // 上次处理进位后的累加次数
+        vector<limb_t> groups;      // 解析缓冲区，复用以免每次分配
+
+        static void normalize(vector<limb_t>& acc) {
+            limb_t carry = 0;
+            for (limb_t& v : acc) {
+                v += carry;
+                carry = v / GROUP_BASE;
+                v %= GROUP_BASE;
+            }
+            for (; carry; carry /= GROUP_BASE) acc.push_back(carry % GROUP_BASE);
+        }
+
+        static BigInt to_bigint(vector<limb_t> acc) {
+            normalize(acc);
+            while (!acc.empty() && acc.back() == 0) acc.pop_back();
+            if (acc.empty()) return BigInt();
+            string digits = std::to_string(acc.back());
+            char buf[GROUP_DIGITS];
+            for (size_t g = acc.size() - 1; g-- > 0;) {
+                limb_t v = acc[g];
+                for (size_t d = GROUP_DIGITS; d-- > 0; v /= 10) buf[d] = (char)('0' + v % 10);
+                digits.append(buf, GROUP_DIGITS);
+            }
+            return BigInt::from_string(digits);
+        }
+
+    public:
+        void add(const BigInt& v) { total += v; }
+
+        // 累加一个十进制字符串（可带正负号），格式错误时抛出 invalid_argument，累加结果不变
+        void add(const char* text, size_t len) {
+            size_t i = 0;
+            bool negative = false;
+            if (i < len && (text[i] == '+' || text[i] == '-')) negative = text[i++] == '-';
+            if (i == len) throw invalid_argument("不是合法的整数: \"" + string(text, len) + "\"");
+
+            // 从低位起每 18 位一组，解析的同时检查字符
+            groups.clear();
+            for (size_t end = len; end > i;) {
+                size_t begin = end - i > GROUP_DIGITS ? end - GROUP_DIGITS : i;
+                limb_t v = 0;
+                for (size_t j = begin; j < end; j++) {
+                    unsigned d = (unsigned)(unsigned char)text[j] - '0';
+                    if (d > 9) throw invalid_argument("不是合法的整数: \"" + string(text, len) + "\"");
+                    v = v * 10 + d;
+                }
+                groups.push_back(v);
+                end = begin;
+            }
+
+            if (pending == CARRY_INTERVAL) {
+                normalize(pos);
+                normalize(neg);
+                pending = 0;
+            }
+            vector<limb_t>& acc = negative ? neg : pos;
+            if (acc.size() < groups.size()) acc.resize(groups.size(), 0);
+            for (size_t g = 0; g < groups.size(); g++) acc[g] += groups[g];
+            pending++;
+        }
+
+        void add(const string& text) { add(text.data(), text.size()); }
+
+        BigInt result() const { return total + to_bigint(pos) - to_bigint(neg); }
+
+        void clear() {
+            total = BigInt();
+            pos.clear();
+            neg.clear();
+            pending = 0;
+        }
+};
+
+BigInt add(const BigInt& x, const BigInt& y);
+
+//==============================================================================
+// 性能测试：与按十进制逐位相加的朴素实现比较
+//==============================================================================
+
+// 朴素实现：非负十进制字符串逐位相加
+string naive_add(const string& a, const string& b) {
+    string r;
+    r.reserve(max(a.size(), b.size()) + 1);
+    int carry = 0;
+    for (size_t i = 0; i < a.size() || i < b.size() || carry; i++) {
+        int d = carry;
+        if (i < a.size()) d += a[a.size() - 1 - i] - '0';
+        if (i < b.size()) d += b[b.size() - 1 - i] - '0';
+        r.push_back((char)('0' + d % 10));
+        carry = d / 10;
+    }
+    reverse(r.begin(), r.end());
+    return r;
+}
+
+string random_digits(mt19937_64& rng, size_t n) {
+    string s(n, '0');
+    for (size_t i = 0; i < n; i++) s[i] = (char)('0' + rng() % 10);
+    if (n > 0 && s[0] == '0') s[0] = '1';
+    return s;
+}
+
+double elapsed_ms(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+    return chrono::duration<double, milli>(b - a).count();
+}
+
+void run_benchmarks() {
+    const size_t DIGITS = 1000000;
+    const int ADD_REPEATS = 200;
+    const size_t BATCH = 20000;
+    const size_t BATCH_DIGITS = 1000;
+    mt19937_64 rng(2024);
+
+    cout << "========== 性能测试 ==========" << endl;
+    cout << "[单次加法] 两个 " << DIGITS << " 位整数 (百万位/秒)" << endl;
+    string sa = random_digits(rng, DIGITS), sb = random_digits(rng, DIGITS);
+
+    auto t0 = chrono::steady_clock::now();
+    BigInt a = BigInt::from_string(sa), b = BigInt::from_string(sb);
+    auto t1 = chrono::steady_clock::now();
+    BigInt c;
+    for (int i = 0; i < ADD_REPEATS; i++) c = a + b;
+    auto t2 = chrono::steady_clock::now();
+    string sc = c.to_string();
+    auto t3 = chrono::steady_clock::now();
+    string naive = naive_add(sa, sb);
+    auto t4 = chrono::steady_clock::now();
+
+    bool ok = sc == naive && a.to_string() == sa && (c - b) == a && (b - c) == -a;
+    double mdigits = DIGITS / 1e6;
+    cout << "解析(分治): " << 2 * mdigits / (elapsed_ms(t0, t1) / 1000)
+         << ", 二进制加法: " << mdigits / (elapsed_ms(t1, t2) / 1000 / ADD_REPEATS)
+         << ", 输出(分治): " << mdigits / (elapsed_ms(t2, t3) / 1000)
+         << ", 朴素逐位加法: " << mdigits / (elapsed_ms(t3, t4) / 1000)
+         << ", 结果一致: " << (ok ? "是" : "否") << endl;
+
+    cout << "[批量求和] " << BATCH << " 个 " << BATCH_DIGITS << " 位整数 (百万位/秒)" << endl;
+    vector<string> inputs(BATCH);
+    for (auto& s : inputs) s = random_digits(rng, BATCH_DIGITS);
+    t0 = chrono::steady_clock::now();
+    BigSum sum;
+    for (const auto& s : inputs) sum.add(s);
+    string fast = sum.result().to_string();
+    t1 = chrono::steady_clock::now();
+    string slow = "0";
+    for (const auto& s : inputs) slow = naive_add(slow, s);
+    t2 = chrono::steady_clock::now();
+    double batchDigits = BATCH * BATCH_DIGITS / 1e6;
+    cout << "BigSum: " << batchDigits / (elapsed_ms(t0, t1) / 1000)
+         << ", 朴素逐位加法: " << batchDigits / (elapsed_ms(t1, t2) / 1000)
+         << ", 结果一致: " << (fast == slow ? "是" : "否") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        run_benchmarks();
+        return 0;
+    }
+
+    string a,b;
     cin>>a>>b;
-    c=add(a,b);
-    cout<<"a+b="<<c<<endl;  
-    return 0; 
-} 
-
-int add(int x, int y) { 
-    int z;
-    z=x+y;  
-    return z; 
-}
\ No newline at end of file
+    try {
+        BigInt c=add(BigInt::from_string(a),BigInt::from_string(b));
+        cout<<"a+b="<<c<<endl;
+    } catch (const invalid_argument& e) {
+        cout<<e.what()<<endl;
+        return 1;
+    }
+    return 0;
+}
+
+BigInt add(const BigInt& x, const BigInt& y) {
+    BigInt z;
+    z=x+y;
+    return z;
+}